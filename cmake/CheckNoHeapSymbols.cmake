@@ -0,0 +1,32 @@
+# Fails if a static library references the heap or the C++ runtime support
+# (malloc family, operator new/delete, __cxa_* exception and guard hooks).
+# Usage: cmake -DNM=<nm> -DLIBRARY=<library> -P CheckNoHeapSymbols.cmake
+
+execute_process(
+    COMMAND "${NM}" -u "${LIBRARY}"
+    OUTPUT_VARIABLE nm_output
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+
+set(forbidden "^_?(malloc|calloc|realloc|free|posix_memalign|aligned_alloc|memalign|valloc)$|^_?_Zn[wa]|^_?_Zd[la]|^_?__cxa_")
+
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+set(violations "")
+foreach(line IN LISTS nm_lines)
+    if(line MATCHES "^[ \t]*U[ \t]+([^ \t]+)")
+        set(symbol "${CMAKE_MATCH_1}")
+        if(symbol MATCHES "${forbidden}")
+            list(APPEND violations "${symbol}")
+        endif()
+    endif()
+endforeach()
+
+if(violations)
+    list(REMOVE_DUPLICATES violations)
+    string(REPLACE ";" "\n  " violations "${violations}")
+    message(FATAL_ERROR "${LIBRARY} references heap or C++ runtime symbols:\n  ${violations}")
+endif()
+message(STATUS "${LIBRARY}: no heap or C++ runtime symbols")
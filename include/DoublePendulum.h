@@ -14,6 +14,52 @@ struct State
         : theta1(t1), theta1_dot(t1d), theta2(t2), theta2_dot(t2d) {}
 };
 
+// Physical parameters of the plant, kept separate so a model can be
+// copied into a controller without holding on to the simulated pendulum
+struct PendulumParams
+{
+    double L1 = 0.5;  // Length of upper arm (meters)
+    double L2 = 0.5;  // Length of lower arm (meters)
+    double m1 = 1.0;  // Mass of upper arm (kg)
+    double m2 = 1.0;  // Mass of lower arm (kg)
+    double g = 9.81;  // Gravity (m/s^2)
+    double b1 = 0.1;  // Friction coefficient for upper joint
+    double b2 = 0.1;  // Friction coefficient for lower joint
+};
+
+// Structure-of-arrays batch of independent pendulums, one lane per
+// parameter scenario, so a rollout advances every lane in one pass
+struct PendulumBatch
+{
+    static constexpr int CAPACITY = 16;
+    
+    int count = 0;
+    
+    // Per-lane state
+    double theta1[CAPACITY];
+    double theta1_dot[CAPACITY];
+    double theta2[CAPACITY];
+    double theta2_dot[CAPACITY];
+    
+    // Per-lane parameters
+    double L1[CAPACITY];
+    double L2[CAPACITY];
+    double m1[CAPACITY];
+    double m2[CAPACITY];
+    double g[CAPACITY];
+    double b1[CAPACITY];
+    double b2[CAPACITY];
+    
+    void setParams(int lane, const PendulumParams& params);
+    void setState(int lane, const State& state);
+};
+
+// sin and cos of n angles, written as straight-line arithmetic so the lane
+// loop vectorizes (libm calls do not). Accurate to about 1 ulp for the
+// angle range of a pendulum; relies on IEEE round-to-nearest, so do not
+// build with -ffast-math.
+void batchSinCos(const double* angles, double* sines, double* cosines, int n);
+
 class DoublePendulum
 {
 public:
@@ -30,6 +76,17 @@ public:
     double getLowerJointX() const;
     double getLowerJointY() const;
     
+    // Snapshot of the physical parameters below
+    PendulumParams getParams() const;
+    void setParams(const PendulumParams& params);
+    
+    // One RK4 step of the dynamics for an arbitrary parameter set.
+    // Pure function: no allocation, no side effects, usable by the controller.
+    static State integrate(const PendulumParams& params, const State& state, double dt, double torque);
+    
+    // Same RK4 step applied to every lane of the batch with a shared torque
+    static void integrateBatch(PendulumBatch& batch, double dt, double torque);
+    
     // Physical parameters
     double L1 = 0.5;  // Length of upper arm (meters)
     double L2 = 0.5;  // Length of lower arm (meters)
@@ -39,11 +96,19 @@ public:
     double b1 = 0.1;  // Friction coefficient for upper joint
     double b2 = 0.1;  // Friction coefficient for lower joint
 
+    // Torque limit enforced by the actuator model
+    static constexpr double MAX_TORQUE = 10.0;
+
 private:
     State state;  // Current system state
     
     // Dynamics equations
-    void computeAccelerations(double torque, double& a1, double& a2);
+    static void computeAccelerations(const PendulumParams& params, const State& state,
+                                     double torque, double& a1, double& a2);
+    static void computeAccelerationsBatch(const PendulumBatch& batch, int lanes,
+                                          const double* theta1, const double* theta1_dot,
+                                          const double* theta2, const double* theta2_dot,
+                                          double torque, double* a1, double* a2);
 };
 
 #endif // DOUBLE_PENDULUM_H
@@ -0,0 +1,56 @@
+#ifndef MPC_CONFIG_H
+#define MPC_CONFIG_H
+
+#include "MPC_Controller.h"
+#include "PolicyController.h"
+#include "Simulation.h"
+#include <string>
+
+// Plain "key = value" text file with the tunable controller settings.
+// Lines starting with '#' are comments; unknown keys are ignored.
+//
+//   prediction_horizon = 50
+//   Q_angle = 1000
+//   Q_angular_vel = 10
+//   R = 0.1
+//
+// Robust mode is enabled with robust_scenarios = K (K > 0); the scenarios are
+// sampled around the controller's model with robust_mass_spread,
+// robust_friction_spread and robust_length_spread. robust_aggregation is
+// 0 for worst case, 1 for CVaR at cvar_alpha.
+//
+// pipelined = 1 selects the host loop's PipelinedController. It and the
+// scenario sampling keys are not controller settings, so they go through
+// HostConfig to survive a load/save round trip.
+
+// Config keys that are not MPC_Controller settings
+struct HostConfig
+{
+    bool pipelined = false;         // Host loop runs PipelinedController
+    int robust_scenarios = -1;      // Scenarios sampled at load time, -1 = key absent
+    ScenarioSpread robust_spread;   // Spread they were sampled with
+};
+
+// Controller with the hand-tuned defaults shared by the GUI and the tools;
+// a config file loaded afterwards overrides them.
+MPC_Controller makeDefaultController(const PendulumParams& model);
+
+// Applies every key found in the file to the controller, and the host keys
+// to host when it is given.
+// Returns false if the file cannot be opened or a value does not parse or is
+// out of range (e.g. prediction_horizon outside [1, MAX_HORIZON], time_step or
+// max_torque <= 0, cvar_alpha outside [0, 1)); the controller is left
+// unchanged in that case.
+bool loadControllerConfig(const std::string& path, MPC_Controller& controller,
+                          HostConfig* host = nullptr);
+
+// Writes the settings of the controller, and the host keys when host is given;
+// header is emitted as a comment.
+bool saveControllerConfig(const std::string& path, const MPC_Controller& controller,
+                          const std::string& header = "", const HostConfig* host = nullptr);
+
+// Policy weight files, in the PolicyNetwork serialized format
+bool loadPolicyWeights(const std::string& path, PolicyController& policy);
+bool savePolicyWeights(const std::string& path, const PolicyNetwork& network);
+
+#endif // MPC_CONFIG_H
@@ -3,13 +3,46 @@
 
 #include "DoublePendulum.h"
 
+// Freestanding controller core: no heap, no exceptions, no iostream.
+// The plant model is copied in, so the controller can run on a target
+// that has no DoublePendulum instance at all.
 class MPC_Controller
 {
 public:
-    MPC_Controller(DoublePendulum* pendulum, int horizon = 200);
+    // Upper bound on prediction_horizon; sizes every internal buffer
+    static constexpr int MAX_HORIZON = 512;
+    
+    // Upper bound on the stored event-triggered plan (0.32 s at time_step 0.01);
+    // plans run out after max_plan_age or this many steps, whichever is first
+    static constexpr int MAX_PLAN_STEPS = 32;
+    
+    // Upper bound on robust-mode parameter scenarios
+    static constexpr int MAX_SCENARIOS = PendulumBatch::CAPACITY;
+    
+    // How robust mode combines the per-scenario costs of a candidate
+    enum class Aggregation
+    {
+        WorstCase,  // Maximum over scenarios
+        CVaR        // Mean of the worst (1 - cvar_alpha) share of scenarios
+    };
+    
+    // Optional executor for candidate evaluation: must call
+    // fn(context, begin, end) over disjoint ranges covering [0, count)
+    // and return when all have finished. Null runs everything inline.
+    typedef void (*ParallelFor)(void* executor, int count,
+                                void (*fn)(void* context, int begin, int end), void* context);
+    
+    MPC_Controller(const PendulumParams& model, int horizon = 200);
     
     double computeControl(const State& state);
-    double simulateAndComputeCost(const State& state, double torque);
+    double simulateAndComputeCost(const State& state, double torque) const;
+    
+    // Cost of a constant torque aggregated over the robust scenarios
+    double robustCost(const State& state, double torque) const;
+    
+    // Forward-simulate the model for duration seconds under a constant torque,
+    // in time_step substeps. Used to compensate for actuation delay.
+    State predictState(const State& state, double torque, double duration) const;
     
     // Parameters
     int prediction_horizon;
@@ -22,12 +55,93 @@ public:
     
     // Control constraints
     double max_torque = 10.0;
+    
+    // Plant model used for prediction
+    PendulumParams model;
+    
+    // Event-triggered replanning: keep the last plan and its predicted
+    // trajectory, and only re-solve when the measured state drifts from the
+    // prediction by more than replan_threshold or the plan runs out. A plan
+    // runs out early where its own prediction moves more than replan_threshold
+    // further from upright than the state it was solved for.
+    bool event_triggered = false;
+    double replan_threshold = 0.01;       // Deviation that forces a re-solve
+    double replan_velocity_weight = 0.3;  // Scale of velocity errors in the deviation (s)
+    double call_interval = 0.01;          // Time between computeControl calls (s)
+    double max_plan_age = 0.02;           // Plan counts as used up after this long (s)
+    
+    // Scenario-based robust mode: every candidate torque is scored over the
+    // plant-parameter scenarios given to setScenarios, rolled out together
+    // as one PendulumBatch, and the costs are aggregated.
+    bool robust = false;
+    Aggregation aggregation = Aggregation::WorstCase;
+    double cvar_alpha = 0.75;
+    
+    // Copies up to MAX_SCENARIOS parameter sets; returns the number kept
+    int setScenarios(const PendulumParams* scenarios, int count);
+    int scenarioCount() const;
+    
+    // Executor used to spread candidate evaluation over threads
+    ParallelFor parallel_for = nullptr;
+    void* parallel_executor = nullptr;
+    
+    // Forget the stored plan so the next call re-solves
+    void invalidatePlan();
+    
+    // Why an event-triggered call re-solved
+    enum class ReplanTrigger
+    {
+        NoPlan,      // First call, or the plan was invalidated
+        Deviation,   // Measured state left the prediction
+        Divergence,  // Prediction itself leaves upright (open loop would fall)
+        PlanAge      // Plan older than max_plan_age
+    };
+    static constexpr int REPLAN_TRIGGERS = 4;
+    
+    // Number of optimizations actually run (every call unless event_triggered)
+    int replanCount() const;
+    
+    // Event-triggered re-solves with the given trigger
+    int replanCount(ReplanTrigger trigger) const;
 
 private:
-    DoublePendulum* pendulum;
+    // Largest candidate set evaluated in one batch (coarse grid + zero)
+    static constexpr int MAX_CANDIDATES = 32;
     
     // Optimize control input using gradient descent or similar
     double optimizeControl(const State& state);
+    
+    // Fills costs[i] for every torques[i], through parallel_for when set
+    void evaluateCandidates(const State& state, const double* torques, int count, double* costs) const;
+    static void evaluateRange(void* context, int begin, int end);
+    
+    // Nominal or robust cost, depending on the mode
+    double candidateCost(const State& state, double torque) const;
+    
+    // prediction_horizon clamped to [1, MAX_HORIZON]
+    int horizonSteps() const;
+    
+    // Prediction steps worth storing for a plan: enough to cover max_plan_age,
+    // at most horizonSteps() and MAX_PLAN_STEPS
+    int planSteps() const;
+    
+    // Weighted distance between a measured state and the stored prediction
+    double planDeviation(const State& measured, const State& predicted) const;
+    
+    // Same weighted distance from the upright target, with wrapped angles
+    double uprightDistance(const State& state) const;
+    
+    // Robust-mode scenario parameters (lane states are filled per rollout)
+    PendulumBatch scenario_batch;
+    
+    // Stored plan for event-triggered mode
+    State planned_trajectory[MAX_PLAN_STEPS + 1];
+    int plan_length = 0;       // Valid entries in planned_trajectory, 0 = no plan
+    double plan_elapsed = 0.0; // Time since the plan was made (s)
+    double plan_torque = 0.0;
+    bool plan_diverges = false; // Prediction was cut where it leaves upright
+    int replan_count = 0;
+    int trigger_counts[REPLAN_TRIGGERS] = {}; // Indexed by ReplanTrigger
 };
 
 #endif // MPC_CONTROLLER_H
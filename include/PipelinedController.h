@@ -0,0 +1,62 @@
+#ifndef PIPELINED_CONTROLLER_H
+#define PIPELINED_CONTROLLER_H
+
+#include "MPC_Controller.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Delay-compensated MPC. At tick k the torque solved during tick k-1 is
+// committed, the state at tick k+1 is predicted by forward-simulating that
+// torque, and the solve for the prediction runs on a worker thread. Its
+// result is applied at the next tick boundary, so the solver gets a full
+// tick of budget and the actuation timing does not depend on solve time.
+class PipelinedController
+{
+public:
+    PipelinedController(const MPC_Controller& controller, double tick_period);
+    ~PipelinedController();
+    
+    PipelinedController(const PipelinedController&) = delete;
+    PipelinedController& operator=(const PipelinedController&) = delete;
+    
+    // Call once per tick boundary with the measured state.
+    // Returns the torque to apply until the next boundary.
+    double tick(const State& measured);
+    
+    // Statistics
+    double lastSolveMicros() const;   // Worker time of the solve applied by the last tick()
+    int overruns() const;             // Solves not ready at the boundary (real-time pacing only)
+    
+    // Inner controller's replan counts as of the last applied solve
+    // (fewer than the solves when it is event_triggered)
+    int replanCount() const;
+    int replanCount(MPC_Controller::ReplanTrigger trigger) const;
+    
+private:
+    MPC_Controller controller;
+    double tick_period;
+    double committed_torque = 0.0;
+    double applied_solve_us = 0.0;
+    int applied_replans = 0;
+    int applied_triggers[MPC_Controller::REPLAN_TRIGGERS] = {};
+    int overrun_count = 0;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool request_pending = false;  // Worker has a state to solve for
+    bool in_flight = false;        // A request was issued and not yet collected
+    bool result_ready = false;
+    bool stopping = false;
+    State request_state;
+    double result_torque = 0.0;
+    double solve_us = 0.0;
+    int result_replans = 0;      // Inner counts published with the result
+    int result_triggers[MPC_Controller::REPLAN_TRIGGERS] = {};
+    
+    void workerLoop();
+    double collectResult();
+};
+
+#endif // PIPELINED_CONTROLLER_H
@@ -0,0 +1,84 @@
+#ifndef POLICY_CONTROLLER_H
+#define POLICY_CONTROLLER_H
+
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include <cstddef>
+
+// Small MLP distilled from MPC_Controller: 6 features -> hidden -> hidden -> torque,
+// ReLU activations. Weights are stored input-major so every layer is a run of
+// contiguous multiply-adds over the hidden units, which the compiler vectorizes.
+//
+// Serialized format (little-endian):
+//   char[4] "DPNN", uint32 version (1), uint32 inputs (6), uint32 hidden,
+//   float max_torque, float input_mean[6], float input_scale[6],
+//   float feature_min[6], float feature_max[6],
+//   float w1[6 * hidden], b1[hidden], w2[hidden * hidden], b2[hidden],
+//   float w3[hidden], b3
+struct PolicyNetwork
+{
+    static constexpr int INPUTS = 6;
+    static constexpr int MAX_HIDDEN = 64;
+    static constexpr int HIDDEN_MULTIPLE = 8;  // hidden must be a multiple of this
+    
+    int hidden = 0;           // 0 = no weights loaded
+    float max_torque = 10.0f; // Output is in units of max_torque
+    
+    // Input normalization: (feature - mean) * scale
+    float input_mean[INPUTS];
+    float input_scale[INPUTS];
+    
+    // Range of each raw feature in the training data
+    float feature_min[INPUTS];
+    float feature_max[INPUTS];
+    
+    alignas(32) float w1[INPUTS * MAX_HIDDEN];      // w1[i * hidden + h]
+    alignas(32) float b1[MAX_HIDDEN];
+    alignas(32) float w2[MAX_HIDDEN * MAX_HIDDEN];  // w2[i * hidden + h]
+    alignas(32) float b2[MAX_HIDDEN];
+    alignas(32) float w3[MAX_HIDDEN];
+    float b3 = 0.0f;
+    
+    // sin/cos of both angles (so wrap-around is seamless) and both velocities
+    static void features(const State& state, float* out);
+    
+    // Forward pass on raw features; returns torque
+    double evaluate(const float* raw_features) const;
+    
+    size_t serializedSize() const;
+    size_t serialize(unsigned char* out, size_t capacity) const;  // Returns bytes written, 0 on failure
+    bool deserialize(const unsigned char* data, size_t size);
+};
+
+// Runtime policy with a fallback to full MPC when the state leaves the
+// region covered by the training data. Allocation-free like the rest of the core.
+class PolicyController
+{
+public:
+    explicit PolicyController(const MPC_Controller& fallback);
+    
+    bool loadWeights(const unsigned char* data, size_t size);
+    bool hasWeights() const;
+    
+    double computeControl(const State& state);
+    
+    // True if every feature lies within the training range widened by ood_margin
+    bool inDistribution(const State& state) const;
+    
+    // Fraction of each feature's training range added on both sides
+    double ood_margin = 0.05;
+    
+    PolicyNetwork network;
+    MPC_Controller fallback;
+    
+    // Statistics
+    int inferenceCount() const;
+    int fallbackCount() const;
+    
+private:
+    int inference_count = 0;
+    int fallback_count = 0;
+    bool fallback_active = false;  // Previous call went to the fallback
+};
+
+#endif // POLICY_CONTROLLER_H
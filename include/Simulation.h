@@ -0,0 +1,74 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include "PolicyController.h"
+#include <vector>
+
+// Headless closed-loop run: same loop as main.cpp without the renderer
+struct SimulationSettings
+{
+    double dt = 0.01;                       // Plant integration step (s)
+    double duration = 10.0;                 // Simulated time (s)
+    double control_update_interval = 0.01;  // Time between MPC solves (s)
+    double upright_tolerance = 0.1;         // Max wrapped angle error counted as upright (rad)
+    double hold_time = 1.0;                 // Time the pendulum must stay upright (s)
+    double steady_state_window = 2.0;       // Trailing window for steady-state error (s)
+    
+    // Timing model for the solve (both false = solve takes zero time, as in main.cpp)
+    bool actuation_delay = false;  // Solve consumes its interval; torque lands one interval late
+    bool pipelined = false;        // PipelinedController: solve for the predicted next state
+    
+    // Random angular-acceleration disturbance on both joints, constant within a tick
+    double disturbance_std = 0.0;  // Standard deviation (rad/s^2)
+    unsigned disturbance_seed = 1;
+};
+
+struct SimulationResult
+{
+    bool reached_upright = false;
+    double time_to_upright = 0.0;     // Start of the first hold_time-long upright interval (s)
+    double steady_state_error = 0.0;  // RMS wrapped angle error over the trailing window (rad)
+    double closed_loop_cost = 0.0;    // Stage cost of the actual trajectory, summed over ticks
+    double mean_solve_us = 0.0;       // Mean wall time per computeControl call (us)
+    double max_solve_us = 0.0;        // Worst wall time per computeControl call (us)
+    int solves = 0;                   // Number of computeControl calls
+    int replans = 0;                  // MPC optimizations actually run
+    int deviation_replans = 0;        // Event-triggered: measured state left the prediction
+    int divergence_replans = 0;       // Event-triggered: prediction left upright
+    int age_replans = 0;              // Event-triggered: plan older than max_plan_age
+    int budget_overruns = 0;          // Solves slower than control_update_interval
+    int ticks = 0;                    // Number of plant steps
+    State final_state;
+};
+
+// Spread of plant parameters around the nominal values for robust MPC
+struct ScenarioSpread
+{
+    double mass = 0.2;      // m1, m2 uniform within +-mass (fraction of nominal)
+    double friction = 2.0;  // b1, b2 log-uniform within [nominal / friction, nominal * friction]
+    double length = 0.0;    // L1, L2 uniform within +-length (fraction of nominal)
+};
+
+// Samples plant-parameter scenarios; the first one is always the nominal plant
+std::vector<PendulumParams> sampleParameterScenarios(const PendulumParams& nominal, const ScenarioSpread& spread,
+                                                     int count, unsigned seed);
+
+// Wrap an angle to (-pi, pi] so 2*pi multiples count as upright
+double wrapAngle(double angle);
+
+// Runs the controller against a plant with the given parameters, starting
+// from initial. The controller is used as-is apart from call_interval, which is
+// set to control_update_interval, so pass a fresh copy per run.
+// In pipelined mode the solves run on a worker thread of a PipelinedController
+// built from a copy of controller; results are still fully deterministic.
+SimulationResult runClosedLoop(MPC_Controller& controller, const PendulumParams& plant,
+                               const State& initial, const SimulationSettings& settings);
+
+// Same loop driven by a distilled policy; the timing settings do not apply.
+// replans counts the MPC fallbacks.
+SimulationResult runClosedLoop(PolicyController& policy, const PendulumParams& plant,
+                               const State& initial, const SimulationSettings& settings);
+
+#endif // SIMULATION_H
@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "MPC_Controller.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads for MPC_Controller::parallel_for.
+// The calling thread takes part in each parallelFor, so a pool of size N
+// starts N - 1 workers. Concurrent parallelFor calls are serialized.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads = 0);  // 0 = hardware concurrency
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void parallelFor(int count, void (*fn)(void* context, int begin, int end), void* context);
+    
+    // Runs job(i) for every i in [0, count); job may be any callable
+    template <typename Job>
+    void parallelForEach(int count, Job job)
+    {
+        parallelFor(count, [](void* context, int begin, int end)
+        {
+            Job& job = *static_cast<Job*>(context);
+            for (int i = begin; i < end; ++i)
+                job(i);
+        }, &job);
+    }
+    
+    int size() const;
+    
+    // Route the controller's candidate evaluation through this pool
+    void attach(MPC_Controller& controller);
+    
+    // Adapter matching MPC_Controller::ParallelFor
+    static void dispatch(void* pool, int count, void (*fn)(void* context, int begin, int end), void* context);
+    
+private:
+    std::vector<std::thread> workers;
+    std::mutex dispatch_mutex;  // One parallelFor at a time
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    
+    unsigned long generation = 0;
+    bool stopping = false;
+    int busy_workers = 0;
+    
+    void (*job_fn)(void*, int, int) = nullptr;
+    void* job_context = nullptr;
+    int job_count = 0;
+    std::atomic<int> next_index;
+    
+    void workerLoop();
+    void runItems();
+};
+
+#endif // THREAD_POOL_H
@@ -1,7 +1,6 @@
 #define _USE_MATH_DEFINES
 #include "DoublePendulum.h"
 #include <cmath>
-#include <algorithm>
 
 DoublePendulum::DoublePendulum()
 {
@@ -20,18 +19,47 @@ State DoublePendulum::getState() const
 }
 
 void DoublePendulum::update(double dt, double torque)
+{
+    state = integrate(getParams(), state, dt, torque);
+}
+
+PendulumParams DoublePendulum::getParams() const
+{
+    PendulumParams params;
+    params.L1 = L1;
+    params.L2 = L2;
+    params.m1 = m1;
+    params.m2 = m2;
+    params.g = g;
+    params.b1 = b1;
+    params.b2 = b2;
+    return params;
+}
+
+void DoublePendulum::setParams(const PendulumParams& params)
+{
+    L1 = params.L1;
+    L2 = params.L2;
+    m1 = params.m1;
+    m2 = params.m2;
+    g = params.g;
+    b1 = params.b1;
+    b2 = params.b2;
+}
+
+State DoublePendulum::integrate(const PendulumParams& params, const State& curr_state, double dt, double torque)
 {
     // Clamp torque to reasonable bounds
-    double clamped_torque = std::max(-10.0, std::min(10.0, torque));
-    
-    State curr_state = state;  // Save current state
+    double clamped_torque = torque;
+    if (clamped_torque > MAX_TORQUE) clamped_torque = MAX_TORQUE;
+    if (clamped_torque < -MAX_TORQUE) clamped_torque = -MAX_TORQUE;
     
     // RK4 integration
     State k1, k2, k3, k4;
     
     // k1
     double a1, a2;
-    computeAccelerations(clamped_torque, a1, a2);
+    computeAccelerations(params, curr_state, clamped_torque, a1, a2);
     k1 = State(curr_state.theta1_dot, a1, curr_state.theta2_dot, a2);
     
     // k2
@@ -41,8 +69,7 @@ void DoublePendulum::update(double dt, double torque)
         curr_state.theta2 + 0.5 * dt * k1.theta2,
         curr_state.theta2_dot + 0.5 * dt * k1.theta2_dot
     );
-    state = temp_state;
-    computeAccelerations(clamped_torque, a1, a2);
+    computeAccelerations(params, temp_state, clamped_torque, a1, a2);
     k2 = State(temp_state.theta1_dot, a1, temp_state.theta2_dot, a2);
     
     // k3
@@ -52,8 +79,7 @@ void DoublePendulum::update(double dt, double torque)
         curr_state.theta2 + 0.5 * dt * k2.theta2,
         curr_state.theta2_dot + 0.5 * dt * k2.theta2_dot
     );
-    state = temp_state;
-    computeAccelerations(clamped_torque, a1, a2);
+    computeAccelerations(params, temp_state, clamped_torque, a1, a2);
     k3 = State(temp_state.theta1_dot, a1, temp_state.theta2_dot, a2);
     
     // k4
@@ -63,19 +89,197 @@ void DoublePendulum::update(double dt, double torque)
         curr_state.theta2 + dt * k3.theta2,
         curr_state.theta2_dot + dt * k3.theta2_dot
     );
-    state = temp_state;
-    computeAccelerations(clamped_torque, a1, a2);
+    computeAccelerations(params, temp_state, clamped_torque, a1, a2);
     k4 = State(temp_state.theta1_dot, a1, temp_state.theta2_dot, a2);
     
     // Update state with RK4 formula
-    state.theta1 = curr_state.theta1 + (dt / 6.0) * (k1.theta1 + 2*k2.theta1 + 2*k3.theta1 + k4.theta1);
-    state.theta1_dot = curr_state.theta1_dot + (dt / 6.0) * (k1.theta1_dot + 2*k2.theta1_dot + 2*k3.theta1_dot + k4.theta1_dot);
-    state.theta2 = curr_state.theta2 + (dt / 6.0) * (k1.theta2 + 2*k2.theta2 + 2*k3.theta2 + k4.theta2);
-    state.theta2_dot = curr_state.theta2_dot + (dt / 6.0) * (k1.theta2_dot + 2*k2.theta2_dot + 2*k3.theta2_dot + k4.theta2_dot);
+    State next;
+    next.theta1 = curr_state.theta1 + (dt / 6.0) * (k1.theta1 + 2*k2.theta1 + 2*k3.theta1 + k4.theta1);
+    next.theta1_dot = curr_state.theta1_dot + (dt / 6.0) * (k1.theta1_dot + 2*k2.theta1_dot + 2*k3.theta1_dot + k4.theta1_dot);
+    next.theta2 = curr_state.theta2 + (dt / 6.0) * (k1.theta2 + 2*k2.theta2 + 2*k3.theta2 + k4.theta2);
+    next.theta2_dot = curr_state.theta2_dot + (dt / 6.0) * (k1.theta2_dot + 2*k2.theta2_dot + 2*k3.theta2_dot + k4.theta2_dot);
+    return next;
 }
 
-void DoublePendulum::computeAccelerations(double torque, double& a1, double& a2)
+void batchSinCos(const double* angles, double* sines, double* cosines, int n)
 {
+    // Reduce to r in [-pi/4, pi/4] around k * pi/2 (Cody-Waite, two-part pi/2)
+    const double two_over_pi = 6.36619772367581382433e-01;
+    const double pio2_hi = 1.57079632673412561417e+00;
+    const double pio2_lo = 6.07710050650619224932e-11;
+    const double round_magic = 6755399441055744.0;  // 1.5 * 2^52: adding it rounds to an integer
+    
+    // fdlibm kernel polynomials for sin and cos on [-pi/4, pi/4]
+    const double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03;
+    const double S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06;
+    const double S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+    const double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03;
+    const double C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07;
+    const double C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+    
+    for (int i = 0; i < n; ++i)
+    {
+        double k = (angles[i] * two_over_pi + round_magic) - round_magic;
+        double r = (angles[i] - k * pio2_hi) - k * pio2_lo;
+        double z = r * r;
+        double sin_r = r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+        double cos_r = 1.0 - 0.5 * z + z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+        
+        // Quadrant: sin = [s, c, -s, -c], cos = [c, -s, -c, s]
+        int quadrant = static_cast<int>(k) & 3;
+        double sin_q = (quadrant & 1) ? cos_r : sin_r;
+        double cos_q = (quadrant & 1) ? sin_r : cos_r;
+        sines[i] = (quadrant & 2) ? -sin_q : sin_q;
+        cosines[i] = ((quadrant + 1) & 2) ? -cos_q : cos_q;
+    }
+}
+
+namespace
+{
+    // count is public; never let it index past the fixed-size lane arrays
+    inline int batchLanes(const PendulumBatch& batch)
+    {
+        if (batch.count < 0) return 0;
+        if (batch.count > PendulumBatch::CAPACITY) return PendulumBatch::CAPACITY;
+        return batch.count;
+    }
+}
+
+void PendulumBatch::setParams(int lane, const PendulumParams& params)
+{
+    L1[lane] = params.L1;
+    L2[lane] = params.L2;
+    m1[lane] = params.m1;
+    m2[lane] = params.m2;
+    g[lane] = params.g;
+    b1[lane] = params.b1;
+    b2[lane] = params.b2;
+}
+
+void PendulumBatch::setState(int lane, const State& state)
+{
+    theta1[lane] = state.theta1;
+    theta1_dot[lane] = state.theta1_dot;
+    theta2[lane] = state.theta2;
+    theta2_dot[lane] = state.theta2_dot;
+}
+
+void DoublePendulum::integrateBatch(PendulumBatch& batch, double dt, double torque)
+{
+    const int n = batchLanes(batch);
+    
+    // Clamp torque to reasonable bounds
+    double clamped_torque = torque;
+    if (clamped_torque > MAX_TORQUE) clamped_torque = MAX_TORQUE;
+    if (clamped_torque < -MAX_TORQUE) clamped_torque = -MAX_TORQUE;
+    
+    // RK4 stage derivatives; position derivatives are the stage velocities
+    double k1_a1[PendulumBatch::CAPACITY], k1_a2[PendulumBatch::CAPACITY];
+    double k2_a1[PendulumBatch::CAPACITY], k2_a2[PendulumBatch::CAPACITY];
+    double k3_a1[PendulumBatch::CAPACITY], k3_a2[PendulumBatch::CAPACITY];
+    double k4_a1[PendulumBatch::CAPACITY], k4_a2[PendulumBatch::CAPACITY];
+    // Stage inputs are zeroed so lanes past n are never read uninitialized
+    double k2_v1[PendulumBatch::CAPACITY] = {}, k2_v2[PendulumBatch::CAPACITY] = {};
+    double k3_v1[PendulumBatch::CAPACITY] = {}, k3_v2[PendulumBatch::CAPACITY] = {};
+    double k4_v1[PendulumBatch::CAPACITY] = {}, k4_v2[PendulumBatch::CAPACITY] = {};
+    double t1[PendulumBatch::CAPACITY] = {}, t2[PendulumBatch::CAPACITY] = {};
+    
+    // k1
+    computeAccelerationsBatch(batch, n, batch.theta1, batch.theta1_dot, batch.theta2, batch.theta2_dot,
+                              clamped_torque, k1_a1, k1_a2);
+    
+    // k2
+    for (int i = 0; i < n; ++i)
+    {
+        t1[i] = batch.theta1[i] + 0.5 * dt * batch.theta1_dot[i];
+        t2[i] = batch.theta2[i] + 0.5 * dt * batch.theta2_dot[i];
+        k2_v1[i] = batch.theta1_dot[i] + 0.5 * dt * k1_a1[i];
+        k2_v2[i] = batch.theta2_dot[i] + 0.5 * dt * k1_a2[i];
+    }
+    computeAccelerationsBatch(batch, n, t1, k2_v1, t2, k2_v2, clamped_torque, k2_a1, k2_a2);
+    
+    // k3
+    for (int i = 0; i < n; ++i)
+    {
+        t1[i] = batch.theta1[i] + 0.5 * dt * k2_v1[i];
+        t2[i] = batch.theta2[i] + 0.5 * dt * k2_v2[i];
+        k3_v1[i] = batch.theta1_dot[i] + 0.5 * dt * k2_a1[i];
+        k3_v2[i] = batch.theta2_dot[i] + 0.5 * dt * k2_a2[i];
+    }
+    computeAccelerationsBatch(batch, n, t1, k3_v1, t2, k3_v2, clamped_torque, k3_a1, k3_a2);
+    
+    // k4
+    for (int i = 0; i < n; ++i)
+    {
+        t1[i] = batch.theta1[i] + dt * k3_v1[i];
+        t2[i] = batch.theta2[i] + dt * k3_v2[i];
+        k4_v1[i] = batch.theta1_dot[i] + dt * k3_a1[i];
+        k4_v2[i] = batch.theta2_dot[i] + dt * k3_a2[i];
+    }
+    computeAccelerationsBatch(batch, n, t1, k4_v1, t2, k4_v2, clamped_torque, k4_a1, k4_a2);
+    
+    // Update state with RK4 formula
+    for (int i = 0; i < n; ++i)
+    {
+        batch.theta1[i] += (dt / 6.0) * (batch.theta1_dot[i] + 2*k2_v1[i] + 2*k3_v1[i] + k4_v1[i]);
+        batch.theta2[i] += (dt / 6.0) * (batch.theta2_dot[i] + 2*k2_v2[i] + 2*k3_v2[i] + k4_v2[i]);
+        batch.theta1_dot[i] += (dt / 6.0) * (k1_a1[i] + 2*k2_a1[i] + 2*k3_a1[i] + k4_a1[i]);
+        batch.theta2_dot[i] += (dt / 6.0) * (k1_a2[i] + 2*k2_a2[i] + 2*k3_a2[i] + k4_a2[i]);
+    }
+}
+
+void DoublePendulum::computeAccelerationsBatch(const PendulumBatch& batch, int lanes,
+                                               const double* theta1, const double* theta1_dot,
+                                               const double* theta2, const double* theta2_dot,
+                                               double torque, double* a1, double* a2)
+{
+    double sin1_lanes[PendulumBatch::CAPACITY], cos1_lanes[PendulumBatch::CAPACITY];
+    double sin2_lanes[PendulumBatch::CAPACITY], cos2_lanes[PendulumBatch::CAPACITY];
+    const int n = lanes;
+    batchSinCos(theta1, sin1_lanes, cos1_lanes, n);
+    batchSinCos(theta2, sin2_lanes, cos2_lanes, n);
+    
+    // Lane loop over contiguous arrays; same equations as computeAccelerations
+    for (int i = 0; i < n; ++i)
+    {
+        const double L1 = batch.L1[i], L2 = batch.L2[i];
+        const double m1 = batch.m1[i], m2 = batch.m2[i];
+        const double g = batch.g[i], b1 = batch.b1[i], b2 = batch.b2[i];
+        
+        // Difference terms from angle-sum identities
+        double sin1 = sin1_lanes[i];
+        double cos1 = cos1_lanes[i];
+        double sin2 = sin2_lanes[i];
+        double cos2 = cos2_lanes[i];
+        double sin12 = sin1 * cos2 - cos1 * sin2;
+        double cos12 = cos1 * cos2 + sin1 * sin2;
+        double w1_sq = theta1_dot[i] * theta1_dot[i];
+        double w2_sq = theta2_dot[i] * theta2_dot[i];
+        
+        double denom = m1 + m2 * (1.0 - cos12 * cos12);
+        
+        a1[i] = (m2 * L2 * w2_sq * sin12 * cos12
+                + m2 * g * sin2 * cos12
+                - m2 * L1 * w1_sq * sin12
+                - (m1 + m2) * g * sin1
+                - b1 * theta1_dot[i]) / (L1 * denom);
+        
+        a2[i] = (-m2 * L2 * w2_sq * sin12
+                - (m1 + m2) * g * sin1 * cos12
+                + (m1 + m2) * L1 * w1_sq * sin12
+                + (m1 + m2) * g * sin2
+                + torque
+                - b2 * theta2_dot[i]) / (L2 * denom);
+    }
+}
+
+void DoublePendulum::computeAccelerations(const PendulumParams& params, const State& state,
+                                          double torque, double& a1, double& a2)
+{
+    const double L1 = params.L1, L2 = params.L2;
+    const double m1 = params.m1, m2 = params.m2;
+    const double g = params.g, b1 = params.b1, b2 = params.b2;
+    
     double theta1 = state.theta1;
     double theta1_dot = state.theta1_dot;
     double theta2 = state.theta2;
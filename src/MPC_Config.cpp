@@ -0,0 +1,204 @@
+#include "MPC_Config.h"
+#include "Simulation.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    std::string trim(const std::string& text)
+    {
+        const char* whitespace = " \t\r\n";
+        size_t begin = text.find_first_not_of(whitespace);
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(whitespace);
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseDouble(const std::string& text, double& value)
+    {
+        std::istringstream stream(text);
+        stream >> value;
+        return !stream.fail() && stream.eof();
+    }
+    
+    // Range the controller can use for each key; unknown keys pass
+    bool valueInRange(const std::string& key, double value)
+    {
+        if (!std::isfinite(value))
+            return false;
+        if (key == "prediction_horizon")
+            return value >= 1.0 && value <= MPC_Controller::MAX_HORIZON;
+        if (key == "time_step" || key == "max_torque")
+            return value > 0.0;
+        if (key == "cvar_alpha" || key == "robust_mass_spread" || key == "robust_length_spread")
+            return value >= 0.0 && value < 1.0;
+        if (key == "robust_scenarios")
+            return value >= 0.0 && value <= MPC_Controller::MAX_SCENARIOS;
+        if (key == "robust_friction_spread")
+            return value >= 1.0;
+        if (key == "Q_angle" || key == "Q_angular_vel" || key == "R" || key == "replan_threshold"
+            || key == "replan_velocity_weight" || key == "max_plan_age")
+            return value >= 0.0;
+        return true;
+    }
+}
+
+MPC_Controller makeDefaultController(const PendulumParams& model)
+{
+    MPC_Controller controller(model, 200);
+    controller.time_step = 0.01;
+    controller.Q_angle = 1000.0;
+    controller.Q_angular_vel = 10.0;
+    controller.R = 0.1;
+    return controller;
+}
+
+bool loadControllerConfig(const std::string& path, MPC_Controller& controller,
+                          HostConfig* host)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    
+    // Parse into a copy so a bad line leaves the caller's controller untouched
+    MPC_Controller parsed = controller;
+    HostConfig parsed_host;
+    
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        
+        size_t separator = line.find('=');
+        if (separator == std::string::npos)
+            return false;
+        
+        std::string key = trim(line.substr(0, separator));
+        double value = 0.0;
+        if (!parseDouble(trim(line.substr(separator + 1)), value) || !valueInRange(key, value))
+            return false;
+        
+        if (key == "prediction_horizon")
+            parsed.prediction_horizon = static_cast<int>(value);
+        else if (key == "time_step")
+            parsed.time_step = value;
+        else if (key == "Q_angle")
+            parsed.Q_angle = value;
+        else if (key == "Q_angular_vel")
+            parsed.Q_angular_vel = value;
+        else if (key == "R")
+            parsed.R = value;
+        else if (key == "max_torque")
+            parsed.max_torque = value;
+        else if (key == "event_triggered")
+            parsed.event_triggered = value != 0.0;
+        else if (key == "replan_threshold")
+            parsed.replan_threshold = value;
+        else if (key == "replan_velocity_weight")
+            parsed.replan_velocity_weight = value;
+        else if (key == "max_plan_age")
+            parsed.max_plan_age = value;
+        else if (key == "robust_scenarios")
+            parsed_host.robust_scenarios = static_cast<int>(value);
+        else if (key == "robust_mass_spread")
+            parsed_host.robust_spread.mass = value;
+        else if (key == "robust_friction_spread")
+            parsed_host.robust_spread.friction = value;
+        else if (key == "robust_length_spread")
+            parsed_host.robust_spread.length = value;
+        else if (key == "robust_aggregation")
+            parsed.aggregation = value != 0.0 ? MPC_Controller::Aggregation::CVaR
+                                                  : MPC_Controller::Aggregation::WorstCase;
+        else if (key == "cvar_alpha")
+            parsed.cvar_alpha = value;
+        else if (key == "pipelined")
+            parsed_host.pipelined = value != 0.0;
+    }
+    
+    if (parsed_host.robust_scenarios >= 0)
+    {
+        std::vector<PendulumParams> scenarios = sampleParameterScenarios(parsed.model, parsed_host.robust_spread,
+                                                                         parsed_host.robust_scenarios, 1);
+        parsed.setScenarios(scenarios.data(), static_cast<int>(scenarios.size()));
+        parsed.robust = parsed_host.robust_scenarios > 0;
+    }
+    
+    controller = parsed;
+    if (host)
+        *host = parsed_host;
+    return true;
+}
+
+bool saveControllerConfig(const std::string& path, const MPC_Controller& controller,
+                          const std::string& header, const HostConfig* host)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+    
+    if (!header.empty())
+    {
+        std::istringstream lines(header);
+        std::string line;
+        while (std::getline(lines, line))
+            file << "# " << line << "\n";
+    }
+    
+    file << std::setprecision(10);
+    file << "prediction_horizon = " << controller.prediction_horizon << "\n";
+    file << "time_step = " << controller.time_step << "\n";
+    file << "Q_angle = " << controller.Q_angle << "\n";
+    file << "Q_angular_vel = " << controller.Q_angular_vel << "\n";
+    file << "R = " << controller.R << "\n";
+    file << "max_torque = " << controller.max_torque << "\n";
+    file << "event_triggered = " << (controller.event_triggered ? 1 : 0) << "\n";
+    file << "replan_threshold = " << controller.replan_threshold << "\n";
+    file << "replan_velocity_weight = " << controller.replan_velocity_weight << "\n";
+    file << "max_plan_age = " << controller.max_plan_age << "\n";
+    file << "robust_aggregation = " << (controller.aggregation == MPC_Controller::Aggregation::CVaR ? 1 : 0) << "\n";
+    file << "cvar_alpha = " << controller.cvar_alpha << "\n";
+    
+    if (host)
+    {
+        file << "pipelined = " << (host->pipelined ? 1 : 0) << "\n";
+        if (host->robust_scenarios >= 0)
+        {
+            file << "robust_scenarios = " << host->robust_scenarios << "\n";
+            file << "robust_mass_spread = " << host->robust_spread.mass << "\n";
+            file << "robust_friction_spread = " << host->robust_spread.friction << "\n";
+            file << "robust_length_spread = " << host->robust_spread.length << "\n";
+        }
+    }
+    
+    return static_cast<bool>(file);
+}
+
+bool loadPolicyWeights(const std::string& path, PolicyController& policy)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return policy.loadWeights(data.data(), data.size());
+}
+
+bool savePolicyWeights(const std::string& path, const PolicyNetwork& network)
+{
+    std::vector<unsigned char> data(network.serializedSize());
+    if (data.empty() || network.serialize(data.data(), data.size()) != data.size())
+        return false;
+    
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
@@ -1,77 +1,316 @@
 #include "MPC_Controller.h"
 #include <cmath>
-#include <algorithm>
 
-MPC_Controller::MPC_Controller(DoublePendulum* pend, int horizon)
-    : pendulum(pend), prediction_horizon(horizon)
+namespace
 {
+    inline double clampTorque(double torque, double limit)
+    {
+        if (torque > limit) return limit;
+        if (torque < -limit) return -limit;
+        return torque;
+    }
+    
+    // Angle error to upright in [-pi, pi]
+    inline double wrapToPi(double angle)
+    {
+        return std::remainder(angle, 6.283185307179586);
+    }
+}
+
+MPC_Controller::MPC_Controller(const PendulumParams& model_params, int horizon)
+    : prediction_horizon(horizon), model(model_params)
+{
+}
+
+int MPC_Controller::horizonSteps() const
+{
+    if (prediction_horizon < 1) return 1;
+    if (prediction_horizon > MAX_HORIZON) return MAX_HORIZON;
+    return prediction_horizon;
+}
+
+int MPC_Controller::planSteps() const
+{
+    int steps = horizonSteps();
+    if (steps > MAX_PLAN_STEPS) steps = MAX_PLAN_STEPS;
+    if (time_step <= 0.0) return steps;
+    
+    // Playback reads index round(plan_elapsed / time_step) while plan_elapsed <= max_plan_age
+    double age_steps = max_plan_age / time_step + 0.5;
+    if (age_steps < steps)
+        steps = age_steps < 1.0 ? 1 : static_cast<int>(age_steps);
+    return steps;
 }
 
 double MPC_Controller::computeControl(const State& state)
 {
-    return optimizeControl(state);
+    if (!event_triggered)
+    {
+        replan_count++;
+        return optimizeControl(state);
+    }
+    
+    // Play back the stored plan while the plant follows its prediction
+    ReplanTrigger trigger = ReplanTrigger::NoPlan;
+    if (plan_length > 0)
+    {
+        plan_elapsed += call_interval;
+        int index = static_cast<int>(plan_elapsed / time_step + 0.5);
+        if (plan_elapsed >= max_plan_age + 1e-9 || (index >= plan_length && !plan_diverges))
+            trigger = ReplanTrigger::PlanAge;
+        else if (index >= plan_length)
+            trigger = ReplanTrigger::Divergence;
+        else if (planDeviation(state, planned_trajectory[index]) > replan_threshold)
+            trigger = ReplanTrigger::Deviation;
+        else
+            return plan_torque;
+    }
+    
+    plan_torque = optimizeControl(state);
+    replan_count++;
+    trigger_counts[static_cast<int>(trigger)]++;
+    
+    // Store the predicted trajectory of the new plan, up to where it starts
+    // to fall away from upright; with an exact model the measured state never
+    // deviates, so this is what ends a plan that would not hold the pendulum
+    const int steps = planSteps();
+    const double start_distance = uprightDistance(state);
+    planned_trajectory[0] = state;
+    plan_length = 1;
+    plan_diverges = false;
+    for (int i = 0; i < steps; ++i)
+    {
+        State next = DoublePendulum::integrate(model, planned_trajectory[i], time_step, plan_torque);
+        if (uprightDistance(next) > start_distance + replan_threshold)
+        {
+            plan_diverges = true;
+            break;
+        }
+        planned_trajectory[plan_length++] = next;
+    }
+    plan_elapsed = 0.0;
+    
+    return plan_torque;
+}
+
+void MPC_Controller::invalidatePlan()
+{
+    plan_length = 0;
+    plan_elapsed = 0.0;
+}
+
+int MPC_Controller::replanCount() const
+{
+    return replan_count;
 }
 
-double MPC_Controller::simulateAndComputeCost(const State& current_state, double torque)
+int MPC_Controller::replanCount(ReplanTrigger trigger) const
+{
+    return trigger_counts[static_cast<int>(trigger)];
+}
+
+double MPC_Controller::planDeviation(const State& measured, const State& predicted) const
+{
+    double d1 = measured.theta1 - predicted.theta1;
+    double d2 = measured.theta2 - predicted.theta2;
+    double v1 = replan_velocity_weight * (measured.theta1_dot - predicted.theta1_dot);
+    double v2 = replan_velocity_weight * (measured.theta2_dot - predicted.theta2_dot);
+    return std::sqrt(d1 * d1 + d2 * d2 + v1 * v1 + v2 * v2);
+}
+
+double MPC_Controller::uprightDistance(const State& state) const
+{
+    double d1 = wrapToPi(state.theta1);
+    double d2 = wrapToPi(state.theta2);
+    double v1 = replan_velocity_weight * state.theta1_dot;
+    double v2 = replan_velocity_weight * state.theta2_dot;
+    return std::sqrt(d1 * d1 + d2 * d2 + v1 * v1 + v2 * v2);
+}
+
+double MPC_Controller::simulateAndComputeCost(const State& current_state, double torque) const
 {
     State sim_state = current_state;
     double total_cost = 0.0;
+    const int steps = horizonSteps();
     
-    for (int i = 0; i < prediction_horizon; ++i)
+    for (int i = 0; i < steps; ++i)
     {
         // Cost for state deviation from target (upright position)
         // double angle_cost = Q_angle * (sim_state.theta1 * sim_state.theta1 + sim_state.theta2 * sim_state.theta2);
-        double angle_cost = Q_angle * ((1 - cos(sim_state.theta1)) + (1 - cos(sim_state.theta2)));
+        double angle_cost = Q_angle * ((1 - std::cos(sim_state.theta1)) + (1 - std::cos(sim_state.theta2)));
         double vel_cost = Q_angular_vel * (sim_state.theta1_dot * sim_state.theta1_dot + sim_state.theta2_dot * sim_state.theta2_dot);
         double control_cost = R * torque * torque;
         
         total_cost += angle_cost + vel_cost + control_cost;
         
         // Simulate one step
-        DoublePendulum temp_pend;
-        temp_pend.setState(sim_state);
-        temp_pend.L1 = pendulum->L1;
-        temp_pend.L2 = pendulum->L2;
-        temp_pend.m1 = pendulum->m1;
-        temp_pend.m2 = pendulum->m2;
-        temp_pend.g = pendulum->g;
-        temp_pend.b1 = pendulum->b1;
-        temp_pend.b2 = pendulum->b2;
-        
-        temp_pend.update(time_step, torque);
-        sim_state = temp_pend.getState();
+        sim_state = DoublePendulum::integrate(model, sim_state, time_step, torque);
     }
     
     return total_cost;
 }
 
+State MPC_Controller::predictState(const State& state, double torque, double duration) const
+{
+    State predicted = state;
+    double remaining = duration;
+    while (remaining > 1e-12)
+    {
+        double step = (time_step <= 0.0 || remaining < time_step) ? remaining : time_step;
+        predicted = DoublePendulum::integrate(model, predicted, step, torque);
+        remaining -= step;
+    }
+    return predicted;
+}
+
+int MPC_Controller::setScenarios(const PendulumParams* scenarios, int count)
+{
+    if (count < 0) count = 0;
+    if (count > MAX_SCENARIOS) count = MAX_SCENARIOS;
+    for (int i = 0; i < count; ++i)
+        scenario_batch.setParams(i, scenarios[i]);
+    scenario_batch.count = count;
+    return count;
+}
+
+int MPC_Controller::scenarioCount() const
+{
+    return scenario_batch.count;
+}
+
+double MPC_Controller::robustCost(const State& current_state, double torque) const
+{
+    PendulumBatch batch = scenario_batch;
+    const int lanes = batch.count;
+    if (lanes == 0)
+        return simulateAndComputeCost(current_state, torque);
+    
+    double lane_cost[MAX_SCENARIOS];
+    for (int i = 0; i < lanes; ++i)
+    {
+        batch.setState(i, current_state);
+        lane_cost[i] = 0.0;
+    }
+    
+    const int steps = horizonSteps();
+    const double control_cost = R * torque * torque;
+    double sin1[MAX_SCENARIOS], cos1[MAX_SCENARIOS], sin2[MAX_SCENARIOS], cos2[MAX_SCENARIOS];
+    for (int step = 0; step < steps; ++step)
+    {
+        // Same stage cost as simulateAndComputeCost, per lane
+        batchSinCos(batch.theta1, sin1, cos1, lanes);
+        batchSinCos(batch.theta2, sin2, cos2, lanes);
+        for (int i = 0; i < lanes; ++i)
+        {
+            double angle_cost = Q_angle * ((1 - cos1[i]) + (1 - cos2[i]));
+            double vel_cost = Q_angular_vel * (batch.theta1_dot[i] * batch.theta1_dot[i] + batch.theta2_dot[i] * batch.theta2_dot[i]);
+            lane_cost[i] += angle_cost + vel_cost + control_cost;
+        }
+        DoublePendulum::integrateBatch(batch, time_step, torque);
+    }
+    
+    double worst = lane_cost[0];
+    for (int i = 1; i < lanes; ++i)
+        if (lane_cost[i] > worst) worst = lane_cost[i];
+    if (aggregation == Aggregation::WorstCase)
+        return worst;
+    
+    // CVaR: sort descending (insertion sort, lanes <= MAX_SCENARIOS) and
+    // average the tail of the distribution
+    for (int i = 1; i < lanes; ++i)
+    {
+        double value = lane_cost[i];
+        int j = i - 1;
+        while (j >= 0 && lane_cost[j] < value)
+        {
+            lane_cost[j + 1] = lane_cost[j];
+            --j;
+        }
+        lane_cost[j + 1] = value;
+    }
+    int tail = static_cast<int>(std::ceil((1.0 - cvar_alpha) * lanes));
+    if (tail < 1) tail = 1;
+    if (tail > lanes) tail = lanes;
+    double sum = 0.0;
+    for (int i = 0; i < tail; ++i)
+        sum += lane_cost[i];
+    return sum / tail;
+}
+
+double MPC_Controller::candidateCost(const State& state, double torque) const
+{
+    if (robust && scenario_batch.count > 0)
+        return robustCost(state, torque);
+    return simulateAndComputeCost(state, torque);
+}
+
+namespace
+{
+    struct CandidateBatch
+    {
+        const MPC_Controller* controller;
+        const State* state;
+        const double* torques;
+        double* costs;
+    };
+}
+
+void MPC_Controller::evaluateRange(void* context, int begin, int end)
+{
+    CandidateBatch* batch = static_cast<CandidateBatch*>(context);
+    for (int i = begin; i < end; ++i)
+        batch->costs[i] = batch->controller->candidateCost(*batch->state, batch->torques[i]);
+}
+
+void MPC_Controller::evaluateCandidates(const State& state, const double* torques, int count, double* costs) const
+{
+    CandidateBatch batch = { this, &state, torques, costs };
+    if (parallel_for && count > 1)
+        parallel_for(parallel_executor, count, &MPC_Controller::evaluateRange, &batch);
+    else
+        evaluateRange(&batch, 0, count);
+}
+
 double MPC_Controller::optimizeControl(const State& state)
 {
-    // Grid search over torque values
-    double best_torque = 0.0;
-    double best_cost = simulateAndComputeCost(state, 0.0);
+    double torques[MAX_CANDIDATES];
+    double costs[MAX_CANDIDATES];
     
+    // Grid search over torque values, with zero torque as the incumbent
+    int count = 0;
+    torques[count++] = 0.0;
     double step = max_torque / 10.0;
-    for (double torque = -max_torque; torque <= max_torque; torque += step)
+    if (step > 0.0)
     {
-        double cost = simulateAndComputeCost(state, torque);
-        if (cost < best_cost)
+        for (double torque = -max_torque; torque <= max_torque && count < MAX_CANDIDATES; torque += step)
+            torques[count++] = torque;
+    }
+    evaluateCandidates(state, torques, count, costs);
+    
+    double best_torque = torques[0];
+    double best_cost = costs[0];
+    for (int i = 1; i < count; ++i)
+    {
+        if (costs[i] < best_cost)
         {
-            best_cost = cost;
-            best_torque = torque;
+            best_cost = costs[i];
+            best_torque = torques[i];
         }
     }
     
     // Fine-tuned search around best torque
     step = step / 5.0;
-    for (double torque = best_torque - 2*step; torque <= best_torque + 2*step; torque += step)
+    count = 0;
+    for (int k = -2; k <= 2; ++k)
+        torques[count++] = clampTorque(best_torque + k * step, max_torque);
+    evaluateCandidates(state, torques, count, costs);
+    
+    for (int i = 0; i < count; ++i)
     {
-        torque = std::max(-max_torque, std::min(max_torque, torque));
-        double cost = simulateAndComputeCost(state, torque);
-        if (cost < best_cost)
+        if (costs[i] < best_cost)
         {
-            best_cost = cost;
-            best_torque = torque;
+            best_cost = costs[i];
+            best_torque = torques[i];
         }
     }
     
@@ -0,0 +1,107 @@
+#include "PipelinedController.h"
+#include <chrono>
+
+PipelinedController::PipelinedController(const MPC_Controller& mpc, double period)
+    : controller(mpc), tick_period(period)
+{
+    // One solve per tick, so an event-triggered plan advances by the tick period
+    controller.call_interval = tick_period;
+    worker = std::thread(&PipelinedController::workerLoop, this);
+}
+
+PipelinedController::~PipelinedController()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
+
+double PipelinedController::tick(const State& measured)
+{
+    // Apply the result of the solve started at the previous boundary
+    if (in_flight)
+        committed_torque = collectResult();
+    
+    // The torque committed now acts on the plant until the next boundary,
+    // so solve for the state the plant will be in when the result lands
+    State predicted = controller.predictState(measured, committed_torque, tick_period);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        request_state = predicted;
+        request_pending = true;
+        result_ready = false;
+    }
+    in_flight = true;
+    condition.notify_all();
+    
+    return committed_torque;
+}
+
+double PipelinedController::lastSolveMicros() const
+{
+    return applied_solve_us;
+}
+
+int PipelinedController::overruns() const
+{
+    return overrun_count;
+}
+
+int PipelinedController::replanCount() const
+{
+    return applied_replans;
+}
+
+int PipelinedController::replanCount(MPC_Controller::ReplanTrigger trigger) const
+{
+    return applied_triggers[static_cast<int>(trigger)];
+}
+
+double PipelinedController::collectResult()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!result_ready)
+    {
+        // The solve used more than its tick; wait so timing stays deterministic
+        overrun_count++;
+        condition.wait(lock, [this] { return result_ready; });
+    }
+    in_flight = false;
+    result_ready = false;
+    applied_solve_us = solve_us;
+    applied_replans = result_replans;
+    for (int i = 0; i < MPC_Controller::REPLAN_TRIGGERS; ++i)
+        applied_triggers[i] = result_triggers[i];
+    return result_torque;
+}
+
+void PipelinedController::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return request_pending || stopping; });
+        if (stopping)
+            return;
+        
+        State state = request_state;
+        request_pending = false;
+        lock.unlock();
+        
+        auto solve_start = std::chrono::steady_clock::now();
+        double torque = controller.computeControl(state);
+        auto solve_end = std::chrono::steady_clock::now();
+        
+        lock.lock();
+        result_torque = torque;
+        solve_us = std::chrono::duration<double, std::micro>(solve_end - solve_start).count();
+        result_replans = controller.replanCount();
+        for (int i = 0; i < MPC_Controller::REPLAN_TRIGGERS; ++i)
+            result_triggers[i] = controller.replanCount(static_cast<MPC_Controller::ReplanTrigger>(i));
+        result_ready = true;
+        condition.notify_all();
+    }
+}
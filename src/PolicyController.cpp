@@ -0,0 +1,227 @@
+#include "PolicyController.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    const char POLICY_MAGIC[4] = { 'D', 'P', 'N', 'N' };
+    const uint32_t POLICY_VERSION = 1;
+    
+    // Byte cursor over a serialized network; fields are copied as-is, so the
+    // format is little-endian on every supported (little-endian) target
+    struct Writer
+    {
+        unsigned char* out;
+        size_t capacity;
+        size_t offset;
+        
+        void put(const void* data, size_t bytes)
+        {
+            if (offset + bytes <= capacity)
+                std::memcpy(out + offset, data, bytes);
+            offset += bytes;
+        }
+    };
+    
+    struct Reader
+    {
+        const unsigned char* data;
+        size_t size;
+        size_t offset;
+        
+        bool get(void* dst, size_t bytes)
+        {
+            if (offset + bytes > size)
+                return false;
+            std::memcpy(dst, data + offset, bytes);
+            offset += bytes;
+            return true;
+        }
+    };
+    
+    template <typename Stream, typename Network>
+    void visitWeights(Stream& stream, Network& net, int inputs)
+    {
+        const int h = net.hidden;
+        stream(&net.max_torque, sizeof(float));
+        stream(net.input_mean, sizeof(float) * inputs);
+        stream(net.input_scale, sizeof(float) * inputs);
+        stream(net.feature_min, sizeof(float) * inputs);
+        stream(net.feature_max, sizeof(float) * inputs);
+        stream(net.w1, sizeof(float) * inputs * h);
+        stream(net.b1, sizeof(float) * h);
+        stream(net.w2, sizeof(float) * h * h);
+        stream(net.b2, sizeof(float) * h);
+        stream(net.w3, sizeof(float) * h);
+        stream(&net.b3, sizeof(float));
+    }
+}
+
+void PolicyNetwork::features(const State& state, float* out)
+{
+    out[0] = static_cast<float>(std::sin(state.theta1));
+    out[1] = static_cast<float>(std::cos(state.theta1));
+    out[2] = static_cast<float>(std::sin(state.theta2));
+    out[3] = static_cast<float>(std::cos(state.theta2));
+    out[4] = static_cast<float>(state.theta1_dot);
+    out[5] = static_cast<float>(state.theta2_dot);
+}
+
+double PolicyNetwork::evaluate(const float* raw_features) const
+{
+    const int h = hidden;
+    alignas(32) float layer1[MAX_HIDDEN];
+    alignas(32) float layer2[MAX_HIDDEN];
+    
+    // Layer 1: axpy per input over the contiguous hidden units
+    for (int k = 0; k < h; ++k)
+        layer1[k] = b1[k];
+    for (int i = 0; i < INPUTS; ++i)
+    {
+        const float x = (raw_features[i] - input_mean[i]) * input_scale[i];
+        const float* row = w1 + i * h;
+        for (int k = 0; k < h; ++k)
+            layer1[k] += row[k] * x;
+    }
+    for (int k = 0; k < h; ++k)
+        layer1[k] = layer1[k] > 0.0f ? layer1[k] : 0.0f;
+    
+    // Layer 2
+    for (int k = 0; k < h; ++k)
+        layer2[k] = b2[k];
+    for (int i = 0; i < h; ++i)
+    {
+        const float x = layer1[i];
+        const float* row = w2 + i * h;
+        for (int k = 0; k < h; ++k)
+            layer2[k] += row[k] * x;
+    }
+    
+    // Output: ReLU and weighting stay elementwise; HIDDEN_MULTIPLE partial
+    // sums keep the reduction vectorizable without reassociating floats
+    float partial[HIDDEN_MULTIPLE] = {};
+    for (int base = 0; base < h; base += HIDDEN_MULTIPLE)
+    {
+        for (int k = 0; k < HIDDEN_MULTIPLE; ++k)
+        {
+            float activation = layer2[base + k] > 0.0f ? layer2[base + k] : 0.0f;
+            partial[k] += w3[base + k] * activation;
+        }
+    }
+    float out = b3;
+    for (int k = 0; k < HIDDEN_MULTIPLE; ++k)
+        out += partial[k];
+    
+    if (out > 1.0f) out = 1.0f;
+    if (out < -1.0f) out = -1.0f;
+    return static_cast<double>(out) * max_torque;
+}
+
+size_t PolicyNetwork::serializedSize() const
+{
+    const size_t h = static_cast<size_t>(hidden);
+    size_t floats = 1 + 4 * INPUTS + INPUTS * h + h + h * h + h + h + 1;
+    return sizeof(POLICY_MAGIC) + 3 * sizeof(uint32_t) + floats * sizeof(float);
+}
+
+size_t PolicyNetwork::serialize(unsigned char* out, size_t capacity) const
+{
+    if (hidden <= 0)
+        return 0;
+    
+    Writer writer = { out, capacity, 0 };
+    uint32_t header[3] = { POLICY_VERSION, static_cast<uint32_t>(INPUTS), static_cast<uint32_t>(hidden) };
+    writer.put(POLICY_MAGIC, sizeof(POLICY_MAGIC));
+    writer.put(header, sizeof(header));
+    
+    auto put = [&writer](const void* data, size_t bytes) { writer.put(data, bytes); };
+    visitWeights(put, *this, INPUTS);
+    
+    return writer.offset <= capacity ? writer.offset : 0;
+}
+
+bool PolicyNetwork::deserialize(const unsigned char* data, size_t size)
+{
+    Reader reader = { data, size, 0 };
+    char magic[4];
+    uint32_t header[3];
+    if (!reader.get(magic, sizeof(magic)) || std::memcmp(magic, POLICY_MAGIC, sizeof(magic)) != 0)
+        return false;
+    if (!reader.get(header, sizeof(header)))
+        return false;
+    if (header[0] != POLICY_VERSION || header[1] != static_cast<uint32_t>(INPUTS))
+        return false;
+    if (header[2] == 0 || header[2] > static_cast<uint32_t>(MAX_HIDDEN) || header[2] % HIDDEN_MULTIPLE != 0)
+        return false;
+    
+    hidden = static_cast<int>(header[2]);
+    bool ok = true;
+    auto get = [&reader, &ok](void* dst, size_t bytes) { ok = reader.get(dst, bytes) && ok; };
+    visitWeights(get, *this, INPUTS);
+    
+    if (!ok || reader.offset != size)
+    {
+        hidden = 0;
+        return false;
+    }
+    return true;
+}
+
+PolicyController::PolicyController(const MPC_Controller& fallback_controller)
+    : fallback(fallback_controller)
+{
+}
+
+bool PolicyController::loadWeights(const unsigned char* data, size_t size)
+{
+    return network.deserialize(data, size);
+}
+
+bool PolicyController::hasWeights() const
+{
+    return network.hidden > 0;
+}
+
+bool PolicyController::inDistribution(const State& state) const
+{
+    float raw[PolicyNetwork::INPUTS];
+    PolicyNetwork::features(state, raw);
+    for (int i = 0; i < PolicyNetwork::INPUTS; ++i)
+    {
+        float margin = static_cast<float>(ood_margin) * (network.feature_max[i] - network.feature_min[i]);
+        if (raw[i] < network.feature_min[i] - margin || raw[i] > network.feature_max[i] + margin)
+            return false;
+    }
+    return true;
+}
+
+double PolicyController::computeControl(const State& state)
+{
+    if (!hasWeights() || !inDistribution(state))
+    {
+        // An event-triggered fallback only sees its own calls, so a plan
+        // left from an earlier fallback stretch is stale by now
+        if (!fallback_active)
+            fallback.invalidatePlan();
+        fallback_active = true;
+        fallback_count++;
+        return fallback.computeControl(state);
+    }
+    
+    float raw[PolicyNetwork::INPUTS];
+    PolicyNetwork::features(state, raw);
+    fallback_active = false;
+    inference_count++;
+    return network.evaluate(raw);
+}
+
+int PolicyController::inferenceCount() const
+{
+    return inference_count;
+}
+
+int PolicyController::fallbackCount() const
+{
+    return fallback_count;
+}
@@ -0,0 +1,215 @@
+#define _USE_MATH_DEFINES
+#include "Simulation.h"
+#include "PipelinedController.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+double wrapAngle(double angle)
+{
+    double wrapped = std::fmod(angle + M_PI, 2.0 * M_PI);
+    if (wrapped <= 0.0)
+        wrapped += 2.0 * M_PI;
+    return wrapped - M_PI;
+}
+
+std::vector<PendulumParams> sampleParameterScenarios(const PendulumParams& nominal, const ScenarioSpread& spread,
+                                                     int count, unsigned seed)
+{
+    std::vector<PendulumParams> scenarios;
+    if (count <= 0)
+        return scenarios;
+    scenarios.push_back(nominal);
+    
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    double log_friction = std::log(spread.friction > 1.0 ? spread.friction : 1.0);
+    while (static_cast<int>(scenarios.size()) < count)
+    {
+        PendulumParams params = nominal;
+        params.m1 *= 1.0 + spread.mass * unit(rng);
+        params.m2 *= 1.0 + spread.mass * unit(rng);
+        params.b1 *= std::exp(log_friction * unit(rng));
+        params.b2 *= std::exp(log_friction * unit(rng));
+        params.L1 *= 1.0 + spread.length * unit(rng);
+        params.L2 *= 1.0 + spread.length * unit(rng);
+        scenarios.push_back(params);
+    }
+    return scenarios;
+}
+
+namespace
+{
+    // Shared closed loop. solve(state, torque, solve_us) runs at every control
+    // boundary, may update torque, and returns false if no solve was timed.
+    // weights supplies the stage cost used for closed_loop_cost.
+    template <typename Solve>
+    SimulationResult simulate(const MPC_Controller& weights, const PendulumParams& plant,
+                              const State& initial, const SimulationSettings& settings, Solve&& solve)
+    {
+        SimulationResult result;
+        
+        State state = initial;
+        double simulation_time = 0.0;
+        double time_since_last_control_update = settings.control_update_interval;  // Solve on the first tick
+        double torque = 0.0;
+        
+        std::mt19937 rng(settings.disturbance_seed);
+        std::normal_distribution<double> disturbance(0.0, 1.0);
+        
+        double upright_since = -1.0;
+        double total_solve_us = 0.0;
+        double error_sq_sum = 0.0;
+        int error_samples = 0;
+        
+        const int total_ticks = static_cast<int>(std::lround(settings.duration / settings.dt));
+        const double window_start = settings.duration - settings.steady_state_window;
+        
+        for (int tick = 0; tick < total_ticks; ++tick)
+        {
+            if (time_since_last_control_update >= settings.control_update_interval - 1e-9)
+            {
+                double solve_us = 0.0;
+                if (solve(state, torque, solve_us))
+                {
+                    total_solve_us += solve_us;
+                    if (solve_us > result.max_solve_us)
+                        result.max_solve_us = solve_us;
+                    if (solve_us > settings.control_update_interval * 1e6)
+                        result.budget_overruns++;
+                    result.solves++;
+                }
+                time_since_last_control_update = 0.0;
+            }
+            
+            // Stage cost of what actually happened, with the controller's weights
+            result.closed_loop_cost += weights.Q_angle * ((1 - std::cos(state.theta1)) + (1 - std::cos(state.theta2)))
+                                     + weights.Q_angular_vel * (state.theta1_dot * state.theta1_dot + state.theta2_dot * state.theta2_dot)
+                                     + weights.R * torque * torque;
+            
+            state = DoublePendulum::integrate(plant, state, settings.dt, torque);
+            if (settings.disturbance_std > 0.0)
+            {
+                state.theta1_dot += settings.disturbance_std * disturbance(rng) * settings.dt;
+                state.theta2_dot += settings.disturbance_std * disturbance(rng) * settings.dt;
+            }
+            simulation_time += settings.dt;
+            time_since_last_control_update += settings.dt;
+            result.ticks++;
+            
+            double e1 = wrapAngle(state.theta1);
+            double e2 = wrapAngle(state.theta2);
+            bool upright = std::fabs(e1) < settings.upright_tolerance && std::fabs(e2) < settings.upright_tolerance;
+            if (!upright)
+                upright_since = -1.0;
+            else if (upright_since < 0.0)
+                upright_since = simulation_time;
+            
+            if (!result.reached_upright && upright_since >= 0.0 && simulation_time - upright_since >= settings.hold_time)
+            {
+                result.reached_upright = true;
+                result.time_to_upright = upright_since;
+            }
+            
+            if (simulation_time > window_start)
+            {
+                error_sq_sum += e1 * e1 + e2 * e2;
+                error_samples++;
+            }
+        }
+        
+        if (result.solves > 0)
+            result.mean_solve_us = total_solve_us / result.solves;
+        if (error_samples > 0)
+            result.steady_state_error = std::sqrt(error_sq_sum / error_samples);
+        result.final_state = state;
+        
+        return result;
+    }
+    
+    double elapsedMicros(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+SimulationResult runClosedLoop(MPC_Controller& controller, const PendulumParams& plant,
+                               const State& initial, const SimulationSettings& settings)
+{
+    typedef MPC_Controller::ReplanTrigger Trigger;
+    const int initial_replans = controller.replanCount();
+    const int initial_deviation = controller.replanCount(Trigger::Deviation);
+    const int initial_divergence = controller.replanCount(Trigger::Divergence);
+    const int initial_age = controller.replanCount(Trigger::PlanAge);
+    
+    // An event-triggered plan must advance by the interval it is actually called at
+    controller.call_interval = settings.control_update_interval;
+    
+    if (settings.pipelined)
+    {
+        PipelinedController pipeline(controller, settings.control_update_interval);
+        bool first = true;
+        SimulationResult result = simulate(controller, plant, initial, settings,
+            [&](const State& state, double& torque, double& solve_us)
+            {
+                // Nothing has been solved before the first boundary
+                torque = pipeline.tick(state);
+                solve_us = pipeline.lastSolveMicros();
+                bool solved = !first;
+                first = false;
+                return solved;
+            });
+        
+        // The pipeline solves on its own copy of the controller
+        result.replans = pipeline.replanCount() - initial_replans;
+        result.deviation_replans = pipeline.replanCount(Trigger::Deviation) - initial_deviation;
+        result.divergence_replans = pipeline.replanCount(Trigger::Divergence) - initial_divergence;
+        result.age_replans = pipeline.replanCount(Trigger::PlanAge) - initial_age;
+        return result;
+    }
+    
+    double delayed_torque = 0.0;  // Solve result waiting for the next interval
+    SimulationResult result = simulate(controller, plant, initial, settings,
+        [&](const State& state, double& torque, double& solve_us)
+        {
+            auto solve_start = std::chrono::steady_clock::now();
+            double solved_torque = controller.computeControl(state);
+            solve_us = elapsedMicros(solve_start);
+            
+            if (settings.actuation_delay)
+            {
+                torque = delayed_torque;
+                delayed_torque = solved_torque;
+            }
+            else
+            {
+                torque = solved_torque;
+            }
+            return true;
+        });
+    
+    result.replans = controller.replanCount() - initial_replans;
+    result.deviation_replans = controller.replanCount(Trigger::Deviation) - initial_deviation;
+    result.divergence_replans = controller.replanCount(Trigger::Divergence) - initial_divergence;
+    result.age_replans = controller.replanCount(Trigger::PlanAge) - initial_age;
+    return result;
+}
+
+SimulationResult runClosedLoop(PolicyController& policy, const PendulumParams& plant,
+                               const State& initial, const SimulationSettings& settings)
+{
+    const int initial_fallbacks = policy.fallbackCount();
+    policy.fallback.call_interval = settings.control_update_interval;
+    SimulationResult result = simulate(policy.fallback, plant, initial, settings,
+        [&](const State& state, double& torque, double& solve_us)
+        {
+            auto solve_start = std::chrono::steady_clock::now();
+            torque = policy.computeControl(state);
+            solve_us = elapsedMicros(solve_start);
+            return true;
+        });
+    
+    // Only fallbacks run an MPC optimization
+    result.replans = policy.fallbackCount() - initial_fallbacks;
+    return result;
+}
@@ -0,0 +1,90 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads)
+    : next_index(0)
+{
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+int ThreadPool::size() const
+{
+    return static_cast<int>(workers.size()) + 1;
+}
+
+void ThreadPool::attach(MPC_Controller& controller)
+{
+    controller.parallel_for = &ThreadPool::dispatch;
+    controller.parallel_executor = this;
+}
+
+void ThreadPool::dispatch(void* pool, int count, void (*fn)(void* context, int begin, int end), void* context)
+{
+    static_cast<ThreadPool*>(pool)->parallelFor(count, fn, context);
+}
+
+void ThreadPool::parallelFor(int count, void (*fn)(void* context, int begin, int end), void* context)
+{
+    if (workers.empty() || count <= 1)
+    {
+        fn(context, 0, count);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job_fn = fn;
+        job_context = context;
+        job_count = count;
+        next_index = 0;
+        busy_workers = static_cast<int>(workers.size());
+        generation++;
+    }
+    work_available.notify_all();
+    
+    runItems();
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this] { return busy_workers == 0; });
+}
+
+void ThreadPool::runItems()
+{
+    // Items are whole rollouts, so hand them out one at a time
+    for (int i = next_index++; i < job_count; i = next_index++)
+        job_fn(job_context, i, i + 1);
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned long seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        work_available.wait(lock, [&] { return stopping || generation != seen_generation; });
+        if (stopping)
+            return;
+        seen_generation = generation;
+        
+        lock.unlock();
+        runItems();
+        lock.lock();
+        
+        if (--busy_workers == 0)
+            work_done.notify_all();
+    }
+}
@@ -1,11 +1,16 @@
 #define _USE_MATH_DEFINES
 #include "DoublePendulum.h"
 #include "MPC_Controller.h"
+#include "MPC_Config.h"
+#include "PipelinedController.h"
+#include "ThreadPool.h"
+#include "PolicyController.h"
 #include "ImGuiRenderer.h"
 #include <iostream>
 #include <chrono>
 #include <iomanip>
 #include <cmath>
+#include <memory>
 
 int main()
 {
@@ -16,11 +21,24 @@ int main()
     DoublePendulum pendulum;
     
     // Create the MPC controller
-    MPC_Controller controller(&pendulum, 200);
-    controller.time_step = 0.01;
-    controller.Q_angle = 1000.0;
-    controller.Q_angular_vel = 10.0;
-    controller.R = 0.1;
+    MPC_Controller controller = makeDefaultController(pendulum.getParams());
+    
+    // Tuned settings from mpc_tuner override the defaults above when present
+    const char* config_path = "mpc_config.txt";
+    HostConfig host_config;
+    if (loadControllerConfig(config_path, controller, &host_config))
+    {
+        std::cout << "Loaded controller config from " << config_path
+                  << " (N=" << controller.prediction_horizon
+                  << ", Q_angle=" << controller.Q_angle
+                  << ", Q_angular_vel=" << controller.Q_angular_vel
+                  << ", R=" << controller.R << ")" << std::endl;
+    }
+    else
+    {
+        std::cout << "No valid controller config at " << config_path
+                  << ", using the built-in defaults" << std::endl;
+    }
     
     // Create ImGui renderer
     ImGuiRenderer renderer(1280, 1280);
@@ -40,6 +58,32 @@ int main()
     double time_since_last_control_update = 0.0;
     double last_torque = 0.0;  // Store the last computed torque
     
+    // Robust mode (robust_scenarios in the config) spreads candidates over all cores
+    std::unique_ptr<ThreadPool> pool;
+    if (controller.robust)
+    {
+        pool.reset(new ThreadPool());
+        pool->attach(controller);
+    }
+    
+    // Event-triggered mode (event_triggered = 1 in the config) steps its
+    // stored plan by one control interval per call
+    controller.call_interval = control_update_interval;
+    
+    // Pipelined mode (pipelined = 1 in the config) solves for the predicted next
+    // state on a worker thread and applies the result one interval later
+    std::unique_ptr<PipelinedController> pipeline;
+    if (host_config.pipelined)
+        pipeline.reset(new PipelinedController(controller, control_update_interval));
+    
+    // A distilled policy from policy_train replaces the MPC solve when present;
+    // it falls back to the controller above outside its training data
+    std::unique_ptr<PolicyController> policy(new PolicyController(controller));
+    if (loadPolicyWeights("policy.bin", *policy))
+        std::cout << "Loaded distilled policy from policy.bin" << std::endl;
+    else
+        policy.reset();
+    
     // Pendulum starts at bottom position (initialized in constructor)
     
     std::cout << "System initialized. Starting control loop..." << std::endl;
@@ -60,7 +104,10 @@ int main()
         if (time_since_last_control_update >= control_update_interval)
         {
             // Compute control using MPC
-            torque = controller.computeControl(state);
+            if (policy)
+                torque = policy->computeControl(state);
+            else
+                torque = pipeline ? pipeline->tick(state) : controller.computeControl(state);
             last_torque = torque;
             
             // Compute cost for display
@@ -99,6 +146,8 @@ int main()
     std::cout << "Total frames: " << frame_count << "\n";
     if (duration.count() > 0)
         std::cout << "Average FPS: " << (frame_count * 1000.0 / duration.count()) << "\n";
+    if (pipeline)
+        std::cout << "Pipelined solves that overran their tick: " << pipeline->overruns() << "\n";
     
     // Print final state
     State final_state = pendulum.getState();
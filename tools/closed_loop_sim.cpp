@@ -0,0 +1,231 @@
+// Headless closed-loop runs of the MPC controller, one row per control mode.
+// Uses the same plant, controller defaults and config file as main.cpp.
+#define _USE_MATH_DEFINES
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include "MPC_Config.h"
+#include "PolicyController.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Mode
+    {
+        std::string name;
+        SimulationSettings settings;
+        bool event_triggered;
+        bool robust;
+        bool policy;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: closed_loop_sim [options]\n"
+                  << "  --config PATH     controller config (default mpc_config.txt if present)\n"
+                  << "  --duration S      simulated seconds (default 10)\n"
+                  << "  --interval S      control update interval (default 0.01)\n"
+                  << "  --initial T1 T2   initial angles in rad (default: hanging, pi pi)\n"
+                  << "  --threshold D     replan threshold for the event mode (default from config)\n"
+                  << "  --plan-age S      max plan age for the event mode (default from config)\n"
+                  << "  --disturbance A   std of random joint accelerations in rad/s^2 (default 0)\n"
+                  << "  --scenarios K     parameter scenarios for the robust mode (default 8)\n"
+                  << "  --cvar A          robust mode aggregates with CVaR at A (default: worst case)\n"
+                  << "  --threads N       threads for robust candidate evaluation (default: all cores)\n"
+                  << "  --plant-mass S    scale the simulated plant's masses by S (default 1)\n"
+                  << "  --plant-friction S  scale the simulated plant's friction by S (default 1)\n"
+                  << "  --policy PATH     distilled policy for the policy mode (default policy.bin if present)\n"
+                  << "  --mode NAME       ideal | delayed | pipelined | event | robust | policy | all (default all)\n";
+    }
+
+    void printResult(const std::string& name, const SimulationResult& result)
+    {
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+                  << std::setw(9) << (result.reached_upright ? "yes" : "no")
+                  << std::setw(10) << std::setprecision(2) << result.time_to_upright
+                  << std::setw(12) << std::setprecision(4) << result.steady_state_error
+                  << std::setw(14) << std::setprecision(0) << result.closed_loop_cost
+                  << std::setw(8) << result.solves
+                  << std::setw(8) << result.replans
+                  << std::setw(6) << result.deviation_replans
+                  << std::setw(6) << result.divergence_replans
+                  << std::setw(6) << result.age_replans
+                  << std::setw(8) << std::setprecision(1)
+                  << (result.solves > 0 ? 100.0 * result.replans / result.solves : 0.0)
+                  << std::setw(12) << std::setprecision(1) << result.mean_solve_us
+                  << std::setw(12) << result.max_solve_us
+                  << std::setw(10) << result.budget_overruns << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string config_path = "mpc_config.txt";
+    bool config_required = false;
+    std::string mode_name = "all";
+    SimulationSettings base;
+    State initial(M_PI, 0.0, M_PI, 0.0);
+    double threshold = -1.0;
+    double plan_age = -1.0;
+    int scenario_count = 8;
+    double cvar_alpha = -1.0;
+    int threads = 0;
+    double plant_mass_scale = 1.0;
+    double plant_friction_scale = 1.0;
+    std::string policy_path = "policy.bin";
+    bool policy_required = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc)
+        {
+            config_path = argv[++i];
+            config_required = true;
+        }
+        else if (arg == "--duration" && i + 1 < argc)
+            base.duration = std::atof(argv[++i]);
+        else if (arg == "--interval" && i + 1 < argc)
+            base.control_update_interval = std::atof(argv[++i]);
+        else if (arg == "--initial" && i + 2 < argc)
+        {
+            initial.theta1 = std::atof(argv[++i]);
+            initial.theta2 = std::atof(argv[++i]);
+        }
+        else if (arg == "--threshold" && i + 1 < argc)
+            threshold = std::atof(argv[++i]);
+        else if (arg == "--plan-age" && i + 1 < argc)
+            plan_age = std::atof(argv[++i]);
+        else if (arg == "--disturbance" && i + 1 < argc)
+            base.disturbance_std = std::atof(argv[++i]);
+        else if (arg == "--scenarios" && i + 1 < argc)
+            scenario_count = std::atoi(argv[++i]);
+        else if (arg == "--cvar" && i + 1 < argc)
+            cvar_alpha = std::atof(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (arg == "--plant-mass" && i + 1 < argc)
+            plant_mass_scale = std::atof(argv[++i]);
+        else if (arg == "--plant-friction" && i + 1 < argc)
+            plant_friction_scale = std::atof(argv[++i]);
+        else if (arg == "--policy" && i + 1 < argc)
+        {
+            policy_path = argv[++i];
+            policy_required = true;
+        }
+        else if (arg == "--mode" && i + 1 < argc)
+            mode_name = argv[++i];
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Same controller setup as main.cpp
+    PendulumParams plant;
+    MPC_Controller controller = makeDefaultController(plant);
+    if (!loadControllerConfig(config_path, controller) && config_required)
+    {
+        std::cerr << "Failed to load " << config_path << std::endl;
+        return 1;
+    }
+    if (threshold >= 0.0)
+        controller.replan_threshold = threshold;
+    if (plan_age >= 0.0)
+        controller.max_plan_age = plan_age;
+    
+    // Robust scenarios come from the config when it sets them, else from --scenarios
+    if (controller.scenarioCount() == 0)
+    {
+        std::vector<PendulumParams> scenarios = sampleParameterScenarios(controller.model, ScenarioSpread(), scenario_count, 1);
+        controller.setScenarios(scenarios.data(), static_cast<int>(scenarios.size()));
+    }
+    if (cvar_alpha >= 0.0)
+    {
+        controller.aggregation = MPC_Controller::Aggregation::CVaR;
+        controller.cvar_alpha = cvar_alpha;
+    }
+    ThreadPool pool(threads);
+    
+    // Policy weights are optional; without them the policy mode is skipped
+    PolicyController policy_template(controller);
+    bool have_policy = loadPolicyWeights(policy_path, policy_template);
+    if (!have_policy && policy_required)
+    {
+        std::cerr << "Failed to load " << policy_path << std::endl;
+        return 1;
+    }
+    
+    // The controller keeps the nominal model; the simulated plant may differ
+    plant.m1 *= plant_mass_scale;
+    plant.m2 *= plant_mass_scale;
+    plant.b1 *= plant_friction_scale;
+    plant.b2 *= plant_friction_scale;
+
+    std::vector<Mode> modes;
+    modes.push_back({ "ideal", base, false, false, false });
+    modes.push_back({ "delayed", base, false, false, false });
+    modes.back().settings.actuation_delay = true;
+    modes.push_back({ "pipelined", base, false, false, false });
+    modes.back().settings.pipelined = true;
+    modes.push_back({ "event", base, true, false, false });
+    modes.push_back({ "robust", base, false, true, false });
+    if (have_policy)
+        modes.push_back({ "policy", base, false, false, true });
+
+    std::cout << "N=" << controller.prediction_horizon << " Q_angle=" << controller.Q_angle
+              << " Q_angular_vel=" << controller.Q_angular_vel << " R=" << controller.R
+              << " replan_threshold=" << controller.replan_threshold
+              << " max_plan_age=" << controller.max_plan_age
+              << " | interval " << base.control_update_interval << " s, " << base.duration << " s"
+              << ", disturbance " << base.disturbance_std << " rad/s^2\n"
+              << "Robust: " << controller.scenarioCount() << " scenarios, "
+              << (controller.aggregation == MPC_Controller::Aggregation::CVaR ? "CVaR" : "worst case")
+              << ", " << pool.size() << " threads | plant mass x" << plant_mass_scale
+              << ", friction x" << plant_friction_scale << "\n";
+    std::cout << std::left << std::setw(12) << "mode" << std::right
+              << std::setw(9) << "upright" << std::setw(10) << "t_up(s)"
+              << std::setw(12) << "ss_err" << std::setw(14) << "cost"
+              << std::setw(8) << "solves" << std::setw(8) << "replans"
+              << std::setw(6) << "dev" << std::setw(6) << "div" << std::setw(6) << "age" << std::setw(8) << "rate%"
+              << std::setw(12) << "mean_us"
+              << std::setw(12) << "max_us" << std::setw(10) << "overruns" << "\n";
+
+    bool ran = false;
+    for (const auto& mode : modes)
+    {
+        if (mode_name != "all" && mode_name != mode.name)
+            continue;
+        if (mode.policy)
+        {
+            // Fallback MPC runs with the nominal settings
+            PolicyController policy(controller);
+            policy.network = policy_template.network;
+            printResult(mode.name, runClosedLoop(policy, plant, initial, mode.settings));
+            ran = true;
+            continue;
+        }
+        
+        MPC_Controller run_controller = controller;
+        run_controller.event_triggered = mode.event_triggered;
+        run_controller.robust = mode.robust;
+        if (mode.robust)
+            pool.attach(run_controller);
+        printResult(mode.name, runClosedLoop(run_controller, plant, initial, mode.settings));
+        ran = true;
+    }
+
+    if (!ran)
+    {
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
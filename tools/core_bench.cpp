@@ -0,0 +1,203 @@
+// Host benchmark for the freestanding controller core.
+// Reports cycle counts for the dynamics step and the MPC solve, and aborts
+// if the core touches the heap while it is being measured (run by ctest).
+#define _USE_MATH_DEFINES
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include "MPC_Config.h"
+#include "PolicyController.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+    // Set while core code runs; any allocation in that window aborts the run
+    bool heap_guard_armed = false;
+
+    void* guardedAlloc(std::size_t size, std::size_t alignment = 0)
+    {
+        if (heap_guard_armed)
+        {
+            std::fprintf(stderr, "core_bench: heap allocation of %zu bytes inside the controller core\n", size);
+            std::abort();
+        }
+        void* ptr = nullptr;
+        if (alignment > sizeof(void*))
+        {
+            if (posix_memalign(&ptr, alignment, size ? size : 1) != 0)
+                ptr = nullptr;
+        }
+        else
+        {
+            ptr = std::malloc(size ? size : 1);
+        }
+        if (!ptr) std::abort();
+        return ptr;
+    }
+
+    inline uint64_t readCycles()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    struct Timing
+    {
+        double cycles_per_call;
+        double ns_per_call;
+    };
+
+    template <typename Fn>
+    Timing measure(int iterations, Fn&& fn)
+    {
+        auto wall_start = std::chrono::steady_clock::now();
+        heap_guard_armed = true;
+        uint64_t start = readCycles();
+        for (int i = 0; i < iterations; ++i)
+            fn(i);
+        uint64_t end = readCycles();
+        heap_guard_armed = false;
+        auto wall_end = std::chrono::steady_clock::now();
+
+        Timing timing;
+        timing.cycles_per_call = static_cast<double>(end - start) / iterations;
+        timing.ns_per_call = std::chrono::duration<double, std::nano>(wall_end - wall_start).count() / iterations;
+        return timing;
+    }
+
+    volatile double sink = 0.0;
+}
+
+// Every replaceable allocation form goes through the guard, including the
+// aligned overloads used for over-aligned types such as PolicyNetwork
+void* operator new(std::size_t size) { return guardedAlloc(size); }
+void* operator new[](std::size_t size) { return guardedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return guardedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return guardedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return guardedAlloc(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return guardedAlloc(size, static_cast<std::size_t>(align)); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return guardedAlloc(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return guardedAlloc(size, static_cast<std::size_t>(align)); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+int main()
+{
+    PendulumParams params;
+    MPC_Controller controller = makeDefaultController(params);
+
+    State near_upright(0.05, 0.0, -0.03, 0.0);
+
+    Timing step = measure(1000000, [&](int i) {
+        State s = DoublePendulum::integrate(params, near_upright, 0.01, (i & 1) ? 1.0 : -1.0);
+        sink += s.theta1;
+    });
+
+    Timing rollout = measure(2000, [&](int i) {
+        sink += controller.simulateAndComputeCost(near_upright, (i & 1) ? 1.0 : -1.0);
+    });
+
+    Timing solve = measure(50, [&](int) {
+        sink += controller.computeControl(near_upright);
+    });
+
+    // Event-triggered mode: follow the plant so calls mix plan playback and replans
+    MPC_Controller event_controller = controller;
+    event_controller.event_triggered = true;
+    State event_state = near_upright;
+    const int replans_before = event_controller.replanCount();
+
+    Timing event_solve = measure(50, [&](int) {
+        double torque = event_controller.computeControl(event_state);
+        event_state = DoublePendulum::integrate(params, event_state, event_controller.call_interval, torque);
+        sink += torque;
+    });
+
+    // Robust mode: 8 scenarios rolled out as one SoA batch
+    const int scenario_count = 8;
+    PendulumParams scenarios[scenario_count];
+    for (int i = 0; i < scenario_count; ++i)
+    {
+        scenarios[i].m2 = params.m2 * (0.8 + 0.05 * i);
+        scenarios[i].b1 = params.b1 * (0.5 + 0.25 * i);
+        scenarios[i].b2 = params.b2 * (0.5 + 0.25 * i);
+    }
+    MPC_Controller robust_controller = controller;
+    robust_controller.setScenarios(scenarios, scenario_count);
+    robust_controller.robust = true;
+
+    Timing batch_rollout = measure(500, [&](int i) {
+        sink += robust_controller.robustCost(near_upright, (i & 1) ? 1.0 : -1.0);
+    });
+
+    Timing robust_solve = measure(10, [&](int) {
+        sink += robust_controller.computeControl(near_upright);
+    });
+
+    // Distilled policy: 32 hidden units with arbitrary weights; only timing matters
+    PolicyController policy(controller);
+    PolicyNetwork& network = policy.network;
+    network.hidden = 32;
+    for (int i = 0; i < PolicyNetwork::INPUTS; ++i)
+    {
+        network.input_mean[i] = 0.0f;
+        network.input_scale[i] = 1.0f;
+        network.feature_min[i] = -10.0f;
+        network.feature_max[i] = 10.0f;
+    }
+    for (int i = 0; i < PolicyNetwork::INPUTS * network.hidden; ++i)
+        network.w1[i] = 0.01f * static_cast<float>((i * 37) % 17 - 8);
+    for (int i = 0; i < network.hidden * network.hidden; ++i)
+        network.w2[i] = 0.01f * static_cast<float>((i * 53) % 19 - 9);
+    for (int i = 0; i < network.hidden; ++i)
+    {
+        network.b1[i] = 0.01f;
+        network.b2[i] = 0.01f;
+        network.w3[i] = 0.01f * static_cast<float>(i % 5 - 2);
+    }
+
+    Timing inference = measure(1000000, [&](int i) {
+        State s = near_upright;
+        s.theta1_dot = (i & 7) * 0.01;
+        sink += policy.computeControl(s);
+    });
+
+    std::printf("=== Controller core benchmark (host) ===\n");
+    std::printf("%-28s %14s %14s\n", "operation", "cycles/call", "ns/call");
+    std::printf("%-28s %14.0f %14.1f\n", "dynamics RK4 step", step.cycles_per_call, step.ns_per_call);
+    std::printf("%-28s %14.0f %14.1f\n", "rollout (horizon 200)", rollout.cycles_per_call, rollout.ns_per_call);
+    std::printf("%-28s %14.0f %14.1f\n", "computeControl", solve.cycles_per_call, solve.ns_per_call);
+    std::printf("%-28s %14.0f %14.1f  (%d replans)\n", "event computeControl", event_solve.cycles_per_call, event_solve.ns_per_call,
+                event_controller.replanCount() - replans_before);
+    std::printf("%-28s %14.0f %14.1f\n", "robust rollout (8 lanes)", batch_rollout.cycles_per_call, batch_rollout.ns_per_call);
+    std::printf("%-28s %14.0f %14.1f\n", "robust computeControl (8)", robust_solve.cycles_per_call, robust_solve.ns_per_call);
+    std::printf("%-28s %14.0f %14.1f\n", "policy computeControl (32)", inference.cycles_per_call, inference.ns_per_call);
+    std::printf("heap allocations in core: none\n");
+
+    return 0;
+}
@@ -0,0 +1,372 @@
+// Automatic tuning of the MPC cost weights (and optionally the horizon).
+// Candidates are proposed by a separable CMA-ES and scored by running short
+// headless closed-loop simulations in parallel; the best configuration is
+// written in the format loaded by main.cpp.
+#define _USE_MATH_DEFINES
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include "MPC_Config.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct TunerOptions
+    {
+        int generations = 30;
+        int population = 0;        // 0 = CMA-ES default for the dimension
+        int scenarios = 8;
+        int threads = 0;           // 0 = hardware concurrency
+        bool tune_horizon = false;
+        double duration = 6.0;
+        double sigma = 0.5;
+        unsigned seed = 1;
+        std::string output = "mpc_config.txt";
+        std::string config_path;   // Starting point; empty = output if it exists
+
+        // Objective weights
+        double w_time = 1.0;       // per second to upright
+        double w_error = 10.0;     // per rad of steady-state RMS error
+        double w_cpu = 1.0;        // per ms of mean solve time
+    };
+
+    // Search space, in log10 for the weights and hundreds of steps for the horizon
+    struct Candidate
+    {
+        std::vector<double> x;
+        double score = 0.0;
+    };
+
+    void applyCandidate(const std::vector<double>& x, bool tune_horizon, MPC_Controller& controller)
+    {
+        controller.Q_angle = std::pow(10.0, std::max(0.0, std::min(5.0, x[0])));
+        controller.Q_angular_vel = std::pow(10.0, std::max(-2.0, std::min(3.0, x[1])));
+        controller.R = std::pow(10.0, std::max(-4.0, std::min(1.0, x[2])));
+        if (tune_horizon)
+        {
+            int horizon = static_cast<int>(std::lround(x[3] * 100.0));
+            controller.prediction_horizon = std::max(5, std::min(MPC_Controller::MAX_HORIZON, horizon));
+        }
+    }
+
+    double scoreRun(const SimulationResult& result, const TunerOptions& options)
+    {
+        // Never reaching upright costs more than reaching it at the last tick
+        double time_term = result.reached_upright ? result.time_to_upright : options.duration + 1.0;
+        return options.w_time * time_term
+             + options.w_error * result.steady_state_error
+             + options.w_cpu * result.mean_solve_us / 1000.0;
+    }
+
+    // Fixed scenario set shared by every candidate (common random numbers)
+    std::vector<State> makeScenarios(int count, unsigned seed)
+    {
+        std::vector<State> scenarios;
+        scenarios.push_back(State(M_PI, 0.0, M_PI, 0.0));  // Hanging, as in main.cpp
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> angle(-0.6, 0.6);
+        std::uniform_real_distribution<double> velocity(-0.5, 0.5);
+        while (static_cast<int>(scenarios.size()) < count)
+            scenarios.push_back(State(angle(rng), velocity(rng), angle(rng), velocity(rng)));
+        return scenarios;
+    }
+
+    // Scores every candidate on every scenario; jobs are spread over the thread pool
+    void evaluate(std::vector<Candidate>& candidates, const std::vector<State>& scenarios,
+                  const MPC_Controller& base, const PendulumParams& plant,
+                  const TunerOptions& options, ThreadPool& pool)
+    {
+        const int job_count = static_cast<int>(candidates.size() * scenarios.size());
+        std::vector<double> job_scores(job_count, 0.0);
+
+        SimulationSettings settings;
+        settings.duration = options.duration;
+
+        pool.parallelForEach(job_count, [&](int job)
+        {
+            const Candidate& candidate = candidates[job / scenarios.size()];
+            MPC_Controller controller = base;
+            applyCandidate(candidate.x, options.tune_horizon, controller);
+            SimulationResult result = runClosedLoop(controller, plant, scenarios[job % scenarios.size()], settings);
+            job_scores[job] = scoreRun(result, options);
+        });
+
+        for (size_t c = 0; c < candidates.size(); ++c)
+        {
+            double sum = 0.0;
+            for (size_t s = 0; s < scenarios.size(); ++s)
+                sum += job_scores[c * scenarios.size() + s];
+            candidates[c].score = sum / scenarios.size();
+        }
+    }
+
+    // Separable CMA-ES (diagonal covariance), Ros & Hansen 2008
+    class SepCMAES
+    {
+    public:
+        SepCMAES(const std::vector<double>& mean, double sigma, int lambda, unsigned seed)
+            : n(static_cast<int>(mean.size())), m(mean), sigma(sigma), rng(seed)
+        {
+            this->lambda = lambda > 0 ? lambda : 4 + static_cast<int>(3.0 * std::log(n));
+            mu = this->lambda / 2;
+
+            weights.resize(mu);
+            for (int i = 0; i < mu; ++i)
+                weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+            double weight_sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+            double weight_sq_sum = 0.0;
+            for (double& w : weights)
+            {
+                w /= weight_sum;
+                weight_sq_sum += w * w;
+            }
+            mu_eff = 1.0 / weight_sq_sum;
+
+            c_sigma = (mu_eff + 2.0) / (n + mu_eff + 5.0);
+            d_sigma = 1.0 + 2.0 * std::max(0.0, std::sqrt((mu_eff - 1.0) / (n + 1.0)) - 1.0) + c_sigma;
+            c_c = (4.0 + mu_eff / n) / (n + 4.0 + 2.0 * mu_eff / n);
+            double c1_full = 2.0 / ((n + 1.3) * (n + 1.3) + mu_eff);
+            double cmu_full = std::min(1.0 - c1_full, 2.0 * (mu_eff - 2.0 + 1.0 / mu_eff) / ((n + 2.0) * (n + 2.0) + mu_eff));
+            c1 = std::min(1.0, c1_full * (n + 2.0) / 3.0);
+            c_mu = std::min(1.0 - c1, cmu_full * (n + 2.0) / 3.0);
+            chi_n = std::sqrt(static_cast<double>(n)) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+            diag_c.assign(n, 1.0);
+            p_sigma.assign(n, 0.0);
+            p_c.assign(n, 0.0);
+        }
+
+        std::vector<Candidate> ask()
+        {
+            std::normal_distribution<double> normal(0.0, 1.0);
+            std::vector<Candidate> population(lambda);
+            for (auto& candidate : population)
+            {
+                candidate.x.resize(n);
+                for (int j = 0; j < n; ++j)
+                    candidate.x[j] = m[j] + sigma * std::sqrt(diag_c[j]) * normal(rng);
+            }
+            return population;
+        }
+
+        void tell(std::vector<Candidate> population)
+        {
+            std::sort(population.begin(), population.end(),
+                      [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+
+            // Weighted recombination of the mu best steps
+            std::vector<double> y_w(n, 0.0);
+            for (int i = 0; i < mu; ++i)
+                for (int j = 0; j < n; ++j)
+                    y_w[j] += weights[i] * (population[i].x[j] - m[j]) / sigma;
+
+            for (int j = 0; j < n; ++j)
+                m[j] += sigma * y_w[j];
+
+            // Step-size path uses C^-1/2 * y_w, which is elementwise for a diagonal C
+            double p_sigma_norm_sq = 0.0;
+            for (int j = 0; j < n; ++j)
+            {
+                p_sigma[j] = (1.0 - c_sigma) * p_sigma[j]
+                           + std::sqrt(c_sigma * (2.0 - c_sigma) * mu_eff) * y_w[j] / std::sqrt(diag_c[j]);
+                p_sigma_norm_sq += p_sigma[j] * p_sigma[j];
+            }
+            double p_sigma_norm = std::sqrt(p_sigma_norm_sq);
+
+            generation++;
+            double h_threshold = std::sqrt(1.0 - std::pow(1.0 - c_sigma, 2.0 * generation)) * (1.4 + 2.0 / (n + 1.0)) * chi_n;
+            double h_sigma = p_sigma_norm < h_threshold ? 1.0 : 0.0;
+
+            for (int j = 0; j < n; ++j)
+            {
+                p_c[j] = (1.0 - c_c) * p_c[j] + h_sigma * std::sqrt(c_c * (2.0 - c_c) * mu_eff) * y_w[j];
+
+                double rank_mu = 0.0;
+                for (int i = 0; i < mu; ++i)
+                {
+                    double y = (population[i].x[j] - (m[j] - sigma * y_w[j])) / sigma;
+                    rank_mu += weights[i] * y * y;
+                }
+                diag_c[j] = (1.0 - c1 - c_mu) * diag_c[j]
+                          + c1 * (p_c[j] * p_c[j] + (1.0 - h_sigma) * c_c * (2.0 - c_c) * diag_c[j])
+                          + c_mu * rank_mu;
+            }
+
+            sigma *= std::exp((c_sigma / d_sigma) * (p_sigma_norm / chi_n - 1.0));
+        }
+
+        const std::vector<double>& mean() const { return m; }
+        double stepSize() const { return sigma; }
+        int populationSize() const { return lambda; }
+
+    private:
+        int n;
+        int lambda = 0;
+        int mu = 0;
+        int generation = 0;
+        std::vector<double> m;
+        double sigma;
+        std::vector<double> weights;
+        double mu_eff = 0.0;
+        double c_sigma = 0.0, d_sigma = 0.0, c_c = 0.0, c1 = 0.0, c_mu = 0.0, chi_n = 0.0;
+        std::vector<double> diag_c, p_sigma, p_c;
+        std::mt19937 rng;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: mpc_tuner [options]\n"
+                  << "  --generations N   CMA-ES generations (default 30)\n"
+                  << "  --population N    candidates per generation, at least 2 (default: CMA-ES rule)\n"
+                  << "  --scenarios N     closed-loop runs per candidate (default 8)\n"
+                  << "  --duration S      simulated seconds per run (default 6)\n"
+                  << "  --threads N       worker threads (default: all cores)\n"
+                  << "  --tune-horizon    also search prediction_horizon\n"
+                  << "  --w-time W        weight per second to upright (default 1)\n"
+                  << "  --w-error W       weight per rad steady-state error (default 10)\n"
+                  << "  --w-cpu W         weight per ms mean solve time (default 1)\n"
+                  << "  --seed N          random seed (default 1)\n"
+                  << "  --config PATH     config to start from; untuned keys are kept (default: the output file if present)\n"
+                  << "  --output PATH     config file to write (default mpc_config.txt)\n";
+    }
+
+    bool parseOptions(int argc, char** argv, TunerOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--tune-horizon")
+                options.tune_horizon = true;
+            else if (arg == "--generations" && has_value)
+                options.generations = std::atoi(argv[++i]);
+            else if (arg == "--population" && has_value)
+            {
+                // Recombination needs at least two parents (mu = lambda / 2)
+                options.population = std::atoi(argv[++i]);
+                if (options.population < 2)
+                    return false;
+            }
+            else if (arg == "--scenarios" && has_value)
+                options.scenarios = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--duration" && has_value)
+                options.duration = std::atof(argv[++i]);
+            else if (arg == "--threads" && has_value)
+                options.threads = std::atoi(argv[++i]);
+            else if (arg == "--w-time" && has_value)
+                options.w_time = std::atof(argv[++i]);
+            else if (arg == "--w-error" && has_value)
+                options.w_error = std::atof(argv[++i]);
+            else if (arg == "--w-cpu" && has_value)
+                options.w_cpu = std::atof(argv[++i]);
+            else if (arg == "--seed" && has_value)
+                options.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--output" && has_value)
+                options.output = argv[++i];
+            else if (arg == "--config" && has_value)
+                options.config_path = argv[++i];
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    TunerOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+
+    // Starting point: the existing config on top of the defaults shared with
+    // main.cpp; keys the tuner does not search are written back unchanged
+    PendulumParams plant;
+    MPC_Controller base = makeDefaultController(plant);
+    HostConfig host;
+    const std::string config_path = options.config_path.empty() ? options.output : options.config_path;
+    bool config_loaded = loadControllerConfig(config_path, base, &host);
+    if (!config_loaded && !options.config_path.empty())
+    {
+        std::cerr << "Failed to load " << config_path << std::endl;
+        return 1;
+    }
+
+    std::vector<double> start = { std::log10(base.Q_angle), std::log10(base.Q_angular_vel), std::log10(base.R) };
+    if (options.tune_horizon)
+        start.push_back(base.prediction_horizon / 100.0);
+
+    std::vector<State> scenarios = makeScenarios(options.scenarios, options.seed);
+    SepCMAES optimizer(start, options.sigma, options.population, options.seed);
+
+    std::cout << "=== MPC Weight Tuner ===\n"
+              << "Dimensions: " << start.size() << " | Population: " << optimizer.populationSize()
+              << " | Scenarios: " << scenarios.size() << " | Threads: " << pool.size() << "\n"
+              << "Starting from " << (config_loaded ? config_path : std::string("the built-in defaults")) << "\n";
+
+    Candidate best;
+    best.x = start;
+    {
+        std::vector<Candidate> initial(1, best);
+        evaluate(initial, scenarios, base, plant, options, pool);
+        best = initial[0];
+    }
+    std::cout << "Initial score: " << std::fixed << std::setprecision(4) << best.score << "\n";
+
+    auto start_time = std::chrono::steady_clock::now();
+    for (int generation = 0; generation < options.generations; ++generation)
+    {
+        std::vector<Candidate> population = optimizer.ask();
+        evaluate(population, scenarios, base, plant, options, pool);
+
+        for (const auto& candidate : population)
+            if (candidate.score < best.score)
+                best = candidate;
+
+        optimizer.tell(population);
+
+        MPC_Controller shown = base;
+        applyCandidate(best.x, options.tune_horizon, shown);
+        std::cout << "Gen " << std::setw(3) << generation + 1
+                  << " | best: " << std::setprecision(4) << best.score
+                  << " | sigma: " << optimizer.stepSize()
+                  << " | Q_angle=" << std::setprecision(2) << shown.Q_angle
+                  << " Q_angular_vel=" << shown.Q_angular_vel
+                  << " R=" << std::setprecision(4) << shown.R
+                  << " N=" << shown.prediction_horizon << std::endl;
+    }
+    auto end_time = std::chrono::steady_clock::now();
+
+    MPC_Controller tuned = base;
+    applyCandidate(best.x, options.tune_horizon, tuned);
+
+    std::ostringstream header;
+    header << "Generated by mpc_tuner (score " << best.score << " over "
+           << scenarios.size() << " scenarios of " << options.duration << " s)";
+    if (!saveControllerConfig(options.output, tuned, header.str(), &host))
+    {
+        std::cerr << "Failed to write " << options.output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Tuning time: " << std::chrono::duration<double>(end_time - start_time).count() << " s\n"
+              << "Best configuration written to " << options.output << std::endl;
+    return 0;
+}
@@ -0,0 +1,583 @@
+// Distills MPC_Controller into a small MLP policy.
+//  1. Dataset: (State, MPC torque) pairs from uniformly sampled states plus
+//     states visited by the teacher in closed loop, solved in parallel.
+//  2. Training: self-contained minibatch Adam on mean squared torque error.
+//  3. Export: PolicyNetwork binary loaded by PolicyController.
+//  4. Report: forward-pass latency and closed-loop results against the teacher.
+#define _USE_MATH_DEFINES
+#include "DoublePendulum.h"
+#include "MPC_Controller.h"
+#include "MPC_Config.h"
+#include "PolicyController.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct TrainerOptions
+    {
+        std::string config_path = "mpc_config.txt";
+        bool config_required = false;
+        std::string output = "policy.bin";
+        std::string dataset_path;       // Optional dump of the generated dataset
+        int samples = 20000;
+        double trajectory_fraction = 0.5;
+        int trajectory_length = 200;    // Ticks recorded per teacher trajectory
+        double angle_range = 0.8;       // Sampled angles within +-range of upright (rad)
+        double velocity_range = 3.0;    // Sampled velocities within +-range (rad/s)
+        int hidden = 32;
+        int epochs = 60;
+        int batch = 64;
+        double learning_rate = 1e-3;
+        int threads = 0;
+        unsigned seed = 1;
+        int eval_runs = 20;
+        double eval_duration = 5.0;
+        double success_error = 0.25;    // Balanced if steady-state RMS error is below this (rad)
+    };
+
+    struct Sample
+    {
+        State state;
+        double torque;
+    };
+
+    State sampleState(std::mt19937& rng, const TrainerOptions& options, double angle_scale)
+    {
+        std::uniform_real_distribution<double> angle(-options.angle_range * angle_scale, options.angle_range * angle_scale);
+        std::uniform_real_distribution<double> velocity(-options.velocity_range * angle_scale, options.velocity_range * angle_scale);
+        return State(angle(rng), velocity(rng), angle(rng), velocity(rng));
+    }
+
+    // Box samples first, then whole teacher trajectories; every job owns its slots
+    std::vector<Sample> generateDataset(const MPC_Controller& teacher, const PendulumParams& plant,
+                                        const TrainerOptions& options, ThreadPool& pool)
+    {
+        const int trajectory_count = static_cast<int>(options.samples * options.trajectory_fraction) / options.trajectory_length;
+        const int box_count = options.samples - trajectory_count * options.trajectory_length;
+        std::vector<Sample> dataset(options.samples);
+
+        pool.parallelForEach(box_count + trajectory_count, [&](int job)
+        {
+            MPC_Controller controller = teacher;
+            std::mt19937 rng(options.seed * 7919u + static_cast<unsigned>(job));
+            if (job < box_count)
+            {
+                Sample& sample = dataset[job];
+                sample.state = sampleState(rng, options, 1.0);
+                sample.torque = controller.computeControl(sample.state);
+                return;
+            }
+
+            // Teacher closed loop from a random start, with a small disturbance for coverage
+            std::normal_distribution<double> disturbance(0.0, 2.0);
+            State state = sampleState(rng, options, 0.5);
+            int base = box_count + (job - box_count) * options.trajectory_length;
+            for (int t = 0; t < options.trajectory_length; ++t)
+            {
+                double torque = controller.computeControl(state);
+                dataset[base + t].state = state;
+                dataset[base + t].torque = torque;
+                state = DoublePendulum::integrate(plant, state, controller.time_step, torque);
+                state.theta1_dot += disturbance(rng) * controller.time_step;
+                state.theta2_dot += disturbance(rng) * controller.time_step;
+            }
+        });
+
+        return dataset;
+    }
+
+    bool saveDataset(const std::string& path, const std::vector<Sample>& dataset)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        for (const auto& sample : dataset)
+        {
+            double row[5] = { sample.state.theta1, sample.state.theta1_dot,
+                              sample.state.theta2, sample.state.theta2_dot, sample.torque };
+            file.write(reinterpret_cast<const char*>(row), sizeof(row));
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Training-time copy of the network in double precision, same layout as PolicyNetwork
+    struct Mlp
+    {
+        int inputs = PolicyNetwork::INPUTS;
+        int hidden = 0;
+        std::vector<double> w1, b1, w2, b2, w3;
+        double b3 = 0.0;
+
+        std::vector<double*> parameters()
+        {
+            std::vector<double*> all;
+            for (auto* layer : { &w1, &b1, &w2, &b2, &w3 })
+                for (auto& value : *layer)
+                    all.push_back(&value);
+            all.push_back(&b3);
+            return all;
+        }
+    };
+
+    struct Gradients
+    {
+        std::vector<double> w1, b1, w2, b2, w3;
+        double b3 = 0.0;
+
+        explicit Gradients(const Mlp& net)
+            : w1(net.w1.size(), 0.0), b1(net.b1.size(), 0.0), w2(net.w2.size(), 0.0),
+              b2(net.b2.size(), 0.0), w3(net.w3.size(), 0.0) {}
+
+        std::vector<double*> values()
+        {
+            std::vector<double*> all;
+            for (auto* layer : { &w1, &b1, &w2, &b2, &w3 })
+                for (auto& value : *layer)
+                    all.push_back(&value);
+            all.push_back(&b3);
+            return all;
+        }
+    };
+
+    // Forward pass; fills activations when backpropagation needs them
+    double forward(const Mlp& net, const double* x, std::vector<double>& h1, std::vector<double>& h2)
+    {
+        const int h = net.hidden;
+        for (int k = 0; k < h; ++k)
+            h1[k] = net.b1[k];
+        for (int i = 0; i < net.inputs; ++i)
+            for (int k = 0; k < h; ++k)
+                h1[k] += net.w1[i * h + k] * x[i];
+        for (int k = 0; k < h; ++k)
+            h1[k] = std::max(0.0, h1[k]);
+
+        for (int k = 0; k < h; ++k)
+            h2[k] = net.b2[k];
+        for (int i = 0; i < h; ++i)
+            for (int k = 0; k < h; ++k)
+                h2[k] += net.w2[i * h + k] * h1[i];
+        for (int k = 0; k < h; ++k)
+            h2[k] = std::max(0.0, h2[k]);
+
+        double out = net.b3;
+        for (int k = 0; k < h; ++k)
+            out += net.w3[k] * h2[k];
+        return out;
+    }
+
+    void backward(const Mlp& net, const double* x, const std::vector<double>& h1, const std::vector<double>& h2,
+                  double d_out, Gradients& grad)
+    {
+        const int h = net.hidden;
+        std::vector<double> d_h2(h), d_h1(h, 0.0);
+
+        grad.b3 += d_out;
+        for (int k = 0; k < h; ++k)
+        {
+            grad.w3[k] += d_out * h2[k];
+            d_h2[k] = h2[k] > 0.0 ? d_out * net.w3[k] : 0.0;
+        }
+
+        for (int i = 0; i < h; ++i)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < h; ++k)
+            {
+                grad.w2[i * h + k] += d_h2[k] * h1[i];
+                sum += net.w2[i * h + k] * d_h2[k];
+            }
+            d_h1[i] = h1[i] > 0.0 ? sum : 0.0;
+        }
+        for (int k = 0; k < h; ++k)
+            grad.b2[k] += d_h2[k];
+
+        for (int i = 0; i < net.inputs; ++i)
+            for (int k = 0; k < h; ++k)
+                grad.w1[i * h + k] += d_h1[k] * x[i];
+        for (int k = 0; k < h; ++k)
+            grad.b1[k] += d_h1[k];
+    }
+
+    struct Normalization
+    {
+        double mean[PolicyNetwork::INPUTS];
+        double scale[PolicyNetwork::INPUTS];
+        double min[PolicyNetwork::INPUTS];
+        double max[PolicyNetwork::INPUTS];
+    };
+
+    Normalization computeNormalization(const std::vector<Sample>& dataset)
+    {
+        const int n = PolicyNetwork::INPUTS;
+        Normalization norm;
+        double sum[n] = {}, sum_sq[n] = {};
+        for (int i = 0; i < n; ++i)
+        {
+            norm.min[i] = 1e300;
+            norm.max[i] = -1e300;
+        }
+        for (const auto& sample : dataset)
+        {
+            float raw[n];
+            PolicyNetwork::features(sample.state, raw);
+            for (int i = 0; i < n; ++i)
+            {
+                sum[i] += raw[i];
+                sum_sq[i] += static_cast<double>(raw[i]) * raw[i];
+                norm.min[i] = std::min(norm.min[i], static_cast<double>(raw[i]));
+                norm.max[i] = std::max(norm.max[i], static_cast<double>(raw[i]));
+            }
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            norm.mean[i] = sum[i] / dataset.size();
+            double variance = sum_sq[i] / dataset.size() - norm.mean[i] * norm.mean[i];
+            norm.scale[i] = 1.0 / std::sqrt(std::max(variance, 1e-12));
+        }
+        return norm;
+    }
+
+    // Normalized inputs and targets (torque / max_torque) as flat arrays
+    void buildMatrices(const std::vector<Sample>& dataset, const Normalization& norm, double max_torque,
+                       std::vector<double>& inputs, std::vector<double>& targets)
+    {
+        const int n = PolicyNetwork::INPUTS;
+        inputs.resize(dataset.size() * n);
+        targets.resize(dataset.size());
+        for (size_t s = 0; s < dataset.size(); ++s)
+        {
+            float raw[n];
+            PolicyNetwork::features(dataset[s].state, raw);
+            for (int i = 0; i < n; ++i)
+                inputs[s * n + i] = (raw[i] - norm.mean[i]) * norm.scale[i];
+            targets[s] = dataset[s].torque / max_torque;
+        }
+    }
+
+    double meanSquaredError(const Mlp& net, const std::vector<double>& inputs, const std::vector<double>& targets,
+                            const std::vector<int>& indices)
+    {
+        std::vector<double> h1(net.hidden), h2(net.hidden);
+        double sum = 0.0;
+        for (int index : indices)
+        {
+            double out = std::max(-1.0, std::min(1.0, forward(net, &inputs[index * net.inputs], h1, h2)));
+            double error = out - targets[index];
+            sum += error * error;
+        }
+        return indices.empty() ? 0.0 : sum / indices.size();
+    }
+
+    Mlp train(const std::vector<double>& inputs, const std::vector<double>& targets,
+              const TrainerOptions& options, double max_torque)
+    {
+        const int n = PolicyNetwork::INPUTS;
+        const int h = options.hidden;
+        std::mt19937 rng(options.seed);
+
+        // He initialization for the ReLU layers
+        Mlp net;
+        net.hidden = h;
+        net.w1.resize(n * h);
+        net.b1.assign(h, 0.0);
+        net.w2.resize(h * h);
+        net.b2.assign(h, 0.0);
+        net.w3.resize(h);
+        std::normal_distribution<double> init1(0.0, std::sqrt(2.0 / n));
+        std::normal_distribution<double> init2(0.0, std::sqrt(2.0 / h));
+        std::normal_distribution<double> init3(0.0, std::sqrt(1.0 / h));
+        for (auto& w : net.w1) w = init1(rng);
+        for (auto& w : net.w2) w = init2(rng);
+        for (auto& w : net.w3) w = init3(rng);
+
+        // 90/10 train/validation split
+        std::vector<int> order(targets.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<int>(i);
+        std::shuffle(order.begin(), order.end(), rng);
+        size_t validation_size = order.size() / 10;
+        std::vector<int> validation(order.begin(), order.begin() + validation_size);
+        std::vector<int> training(order.begin() + validation_size, order.end());
+
+        // Adam state
+        std::vector<double*> params = net.parameters();
+        std::vector<double> m(params.size(), 0.0), v(params.size(), 0.0);
+        const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+        int step = 0;
+
+        std::vector<double> h1(h), h2(h);
+        for (int epoch = 0; epoch < options.epochs; ++epoch)
+        {
+            std::shuffle(training.begin(), training.end(), rng);
+            for (size_t start = 0; start < training.size(); start += options.batch)
+            {
+                size_t end = std::min(training.size(), start + static_cast<size_t>(options.batch));
+                Gradients grad(net);
+                for (size_t b = start; b < end; ++b)
+                {
+                    const double* x = &inputs[training[b] * n];
+                    double out = forward(net, x, h1, h2);
+                    double d_out = 2.0 * (out - targets[training[b]]) / (end - start);
+                    backward(net, x, h1, h2, d_out, grad);
+                }
+
+                step++;
+                std::vector<double*> grads = grad.values();
+                double correction1 = 1.0 - std::pow(beta1, step);
+                double correction2 = 1.0 - std::pow(beta2, step);
+                for (size_t p = 0; p < params.size(); ++p)
+                {
+                    double g = *grads[p];
+                    m[p] = beta1 * m[p] + (1.0 - beta1) * g;
+                    v[p] = beta2 * v[p] + (1.0 - beta2) * g * g;
+                    *params[p] -= options.learning_rate * (m[p] / correction1) / (std::sqrt(v[p] / correction2) + epsilon);
+                }
+            }
+
+            if ((epoch + 1) % 10 == 0 || epoch + 1 == options.epochs)
+            {
+                std::cout << "Epoch " << std::setw(4) << epoch + 1 << " | torque RMS error train "
+                          << std::fixed << std::setprecision(4)
+                          << std::sqrt(meanSquaredError(net, inputs, targets, training)) * max_torque
+                          << " N*m, validation "
+                          << std::sqrt(meanSquaredError(net, inputs, targets, validation)) * max_torque
+                          << " N*m" << std::endl;
+            }
+        }
+        return net;
+    }
+
+    void exportNetwork(const Mlp& net, const Normalization& norm, double max_torque, PolicyNetwork& out)
+    {
+        const int n = PolicyNetwork::INPUTS;
+        out.hidden = net.hidden;
+        out.max_torque = static_cast<float>(max_torque);
+        for (int i = 0; i < n; ++i)
+        {
+            out.input_mean[i] = static_cast<float>(norm.mean[i]);
+            out.input_scale[i] = static_cast<float>(norm.scale[i]);
+            out.feature_min[i] = static_cast<float>(norm.min[i]);
+            out.feature_max[i] = static_cast<float>(norm.max[i]);
+        }
+        for (size_t i = 0; i < net.w1.size(); ++i) out.w1[i] = static_cast<float>(net.w1[i]);
+        for (size_t i = 0; i < net.b1.size(); ++i) out.b1[i] = static_cast<float>(net.b1[i]);
+        for (size_t i = 0; i < net.w2.size(); ++i) out.w2[i] = static_cast<float>(net.w2[i]);
+        for (size_t i = 0; i < net.b2.size(); ++i) out.b2[i] = static_cast<float>(net.b2[i]);
+        for (size_t i = 0; i < net.w3.size(); ++i) out.w3[i] = static_cast<float>(net.w3[i]);
+        out.b3 = static_cast<float>(net.b3);
+    }
+
+    struct EvalSummary
+    {
+        int balanced = 0;
+        int upright = 0;
+        double cost = 0.0;
+        double call_us = 0.0;
+        double fallback_rate = 0.0;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: policy_train [options]\n"
+                  << "  --config PATH       teacher config (default mpc_config.txt if present)\n"
+                  << "  --samples N         dataset size (default 20000)\n"
+                  << "  --dataset PATH      also write the dataset (5 doubles per row)\n"
+                  << "  --hidden N          hidden units per layer, multiple of 8, <= 64 (default 32)\n"
+                  << "  --epochs N          training epochs (default 60)\n"
+                  << "  --batch N           minibatch size (default 64)\n"
+                  << "  --lr X              Adam learning rate (default 1e-3)\n"
+                  << "  --threads N         dataset/evaluation threads (default: all cores)\n"
+                  << "  --eval N            closed-loop evaluation runs (default 20)\n"
+                  << "  --seed N            random seed (default 1)\n"
+                  << "  --output PATH       policy weights to write (default policy.bin)\n";
+    }
+
+    bool parseOptions(int argc, char** argv, TrainerOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--config" && has_value)
+            {
+                options.config_path = argv[++i];
+                options.config_required = true;
+            }
+            else if (arg == "--samples" && has_value)
+                options.samples = std::max(100, std::atoi(argv[++i]));
+            else if (arg == "--dataset" && has_value)
+                options.dataset_path = argv[++i];
+            else if (arg == "--hidden" && has_value)
+                options.hidden = std::atoi(argv[++i]);
+            else if (arg == "--epochs" && has_value)
+                options.epochs = std::atoi(argv[++i]);
+            else if (arg == "--batch" && has_value)
+                options.batch = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--lr" && has_value)
+                options.learning_rate = std::atof(argv[++i]);
+            else if (arg == "--threads" && has_value)
+                options.threads = std::atoi(argv[++i]);
+            else if (arg == "--eval" && has_value)
+                options.eval_runs = std::atoi(argv[++i]);
+            else if (arg == "--seed" && has_value)
+                options.seed = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--output" && has_value)
+                options.output = argv[++i];
+            else
+                return false;
+        }
+        return options.hidden > 0 && options.hidden <= PolicyNetwork::MAX_HIDDEN
+            && options.hidden % PolicyNetwork::HIDDEN_MULTIPLE == 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    TrainerOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+    ThreadPool pool(options.threads);
+
+    // Teacher: same setup as main.cpp
+    PendulumParams plant;
+    MPC_Controller teacher = makeDefaultController(plant);
+    if (!loadControllerConfig(options.config_path, teacher) && options.config_required)
+    {
+        std::cerr << "Failed to load " << options.config_path << std::endl;
+        return 1;
+    }
+    teacher.event_triggered = false;
+
+    std::cout << "=== MPC Policy Distillation ===\n"
+              << "Teacher: N=" << teacher.prediction_horizon << " Q_angle=" << teacher.Q_angle
+              << " Q_angular_vel=" << teacher.Q_angular_vel << " R=" << teacher.R
+              << " | Threads: " << pool.size() << std::endl;
+
+    auto generate_start = std::chrono::steady_clock::now();
+    std::vector<Sample> dataset = generateDataset(teacher, plant, options, pool);
+    std::cout << "Generated " << dataset.size() << " samples in " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - generate_start).count()
+              << " s" << std::endl;
+    if (!options.dataset_path.empty() && !saveDataset(options.dataset_path, dataset))
+        std::cerr << "Failed to write " << options.dataset_path << std::endl;
+
+    Normalization norm = computeNormalization(dataset);
+    std::vector<double> inputs, targets;
+    buildMatrices(dataset, norm, teacher.max_torque, inputs, targets);
+
+    auto train_start = std::chrono::steady_clock::now();
+    Mlp net = train(inputs, targets, options, teacher.max_torque);
+    std::cout << "Training time: " << std::setprecision(1)
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - train_start).count()
+              << " s" << std::endl;
+
+    PolicyController policy(teacher);
+    exportNetwork(net, norm, teacher.max_torque, policy.network);
+    if (!savePolicyWeights(options.output, policy.network))
+    {
+        std::cerr << "Failed to write " << options.output << std::endl;
+        return 1;
+    }
+    std::cout << "Policy written to " << options.output << " (" << policy.network.serializedSize() << " bytes)\n";
+
+    // Forward-pass latency against one teacher solve
+    const int latency_iterations = 200000;
+    volatile double sink = 0.0;
+    float raw[PolicyNetwork::INPUTS];
+    PolicyNetwork::features(dataset[0].state, raw);
+    auto latency_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < latency_iterations; ++i)
+    {
+        raw[4] = static_cast<float>(i & 7) * 0.01f;
+        sink = sink + policy.network.evaluate(raw);
+    }
+    double inference_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - latency_start).count()
+                        / latency_iterations;
+
+    MPC_Controller timing_teacher = teacher;
+    const int solve_iterations = 20;
+    auto solve_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < solve_iterations; ++i)
+        sink = sink + timing_teacher.computeControl(dataset[i].state);
+    double solve_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - solve_start).count()
+                    / solve_iterations;
+
+    // Closed loop from the same random starts for teacher and student
+    std::vector<State> starts;
+    std::mt19937 rng(options.seed + 1000);
+    for (int i = 0; i < options.eval_runs; ++i)
+        starts.push_back(sampleState(rng, options, 0.5));
+
+    SimulationSettings settings;
+    settings.duration = options.eval_duration;
+    std::vector<SimulationResult> teacher_results(starts.size()), policy_results(starts.size());
+    std::vector<double> fallback_rates(starts.size(), 0.0);
+    pool.parallelForEach(static_cast<int>(starts.size()) * 2, [&](int job)
+    {
+        int run = job / 2;
+        if (job % 2 == 0)
+        {
+            MPC_Controller controller = teacher;
+            teacher_results[run] = runClosedLoop(controller, plant, starts[run], settings);
+        }
+        else
+        {
+            PolicyController student(teacher);
+            student.network = policy.network;
+            policy_results[run] = runClosedLoop(student, plant, starts[run], settings);
+            int calls = student.inferenceCount() + student.fallbackCount();
+            fallback_rates[run] = calls > 0 ? static_cast<double>(student.fallbackCount()) / calls : 0.0;
+        }
+    });
+
+    auto summarize = [&](const std::vector<SimulationResult>& results, const std::vector<double>* fallbacks)
+    {
+        EvalSummary summary;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (results[i].steady_state_error < options.success_error) summary.balanced++;
+            if (results[i].reached_upright) summary.upright++;
+            summary.cost += results[i].closed_loop_cost / results.size();
+            summary.call_us += results[i].mean_solve_us / results.size();
+            if (fallbacks) summary.fallback_rate += (*fallbacks)[i] / results.size();
+        }
+        return summary;
+    };
+    EvalSummary teacher_summary = summarize(teacher_results, nullptr);
+    EvalSummary policy_summary = summarize(policy_results, &fallback_rates);
+
+    std::cout << "\nForward pass: " << std::setprecision(1) << inference_ns << " ns"
+              << " | teacher solve: " << solve_ns / 1000.0 << " us"
+              << " | speedup: " << std::setprecision(0) << solve_ns / inference_ns << "x\n";
+    std::cout << "Closed loop over " << starts.size() << " starts, " << options.eval_duration
+              << " s each (balanced = steady-state RMS error < " << std::setprecision(2) << options.success_error << " rad)\n";
+    std::cout << std::left << std::setw(10) << "" << std::right << std::setw(12) << "balanced"
+              << std::setw(10) << "upright" << std::setw(14) << "mean cost" << std::setw(14) << "us/tick"
+              << std::setw(12) << "fallback%" << "\n";
+    auto print_row = [&](const char* name, const EvalSummary& summary)
+    {
+        std::cout << std::left << std::setw(10) << name << std::right
+                  << std::setw(7) << summary.balanced << "/" << std::setw(4) << std::left << starts.size() << std::right
+                  << std::setw(10) << summary.upright << std::setprecision(0) << std::setw(14) << summary.cost
+                  << std::setprecision(2) << std::setw(14) << summary.call_us
+                  << std::setprecision(1) << std::setw(12) << summary.fallback_rate * 100.0 << "\n";
+    };
+    print_row("teacher", teacher_summary);
+    print_row("policy", policy_summary);
+
+    return 0;
+}